@@ -0,0 +1,110 @@
+//=======================================================================
+// Copyright (c) 2013-2020 Baptiste Wicht.
+// Distributed under the terms of the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+// Microbenchmark of the aggregation of transactions: sums over records
+// (like the expenses) against the kernels over the transaction columns
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "aggregation.hpp"
+
+namespace {
+
+// Same layout as an expense
+struct record {
+    size_t id;
+    std::string guid;
+    uint32_t day;
+    std::string name;
+    size_t account;
+    int64_t amount;
+};
+
+template <typename Functor>
+double measure(size_t repeat, Functor functor) {
+    auto start = std::chrono::steady_clock::now();
+
+    for (size_t i = 0; i < repeat; ++i) {
+        functor();
+    }
+
+    auto end = std::chrono::steady_clock::now();
+
+    return std::chrono::duration<double, std::milli>(end - start).count() / repeat;
+}
+
+void report(const std::string& name, double records_ms, double kernel_ms) {
+    std::cout << name << ": records " << records_ms << "ms, kernels " << kernel_ms << "ms, speedup " << records_ms / kernel_ms << "x" << std::endl;
+}
+
+volatile int64_t sink;
+
+} // end of anonymous namespace
+
+int main(int argc, char** argv) {
+    size_t n      = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 4000000;
+    size_t repeat = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 10;
+
+    std::mt19937_64 generator(42);
+    std::uniform_int_distribution<uint32_t> day_distribution(730000, 740000);
+    std::uniform_int_distribution<uint32_t> account_distribution(1, 20);
+    std::uniform_int_distribution<int64_t> amount_distribution(1, 100000);
+
+    std::vector<record> records(n);
+    std::vector<uint32_t> days(n);
+    std::vector<uint32_t> accounts(n);
+    std::vector<int64_t> amounts(n);
+
+    for (size_t i = 0; i < n; ++i) {
+        days[i]     = day_distribution(generator);
+        accounts[i] = account_distribution(generator);
+        amounts[i]  = amount_distribution(generator);
+
+        records[i] = {i, "cf4a3f70-54a0-4a86-9bd0-2c4a8f4d4e1d", days[i], "Some expense name that is long enough", accounts[i], amounts[i]};
+    }
+
+    std::cout << "Aggregation of " << n << " transactions with the " << budget::aggregation_kernels() << " kernels" << std::endl;
+
+    const uint32_t account   = 7;
+    const uint32_t first_day = 732000;
+    const uint32_t last_day  = 736000;
+
+    auto records_account = measure(repeat, [&]() {
+        int64_t total = 0;
+        for (auto& r : records) {
+            if (r.account == account) {
+                total += r.amount;
+            }
+        }
+        sink = total;
+    });
+
+    auto kernel_account = measure(repeat, [&]() { sink = budget::masked_sum(accounts.data(), amounts.data(), n, account); });
+
+    report("account sum", records_account, kernel_account);
+
+    auto records_masked = measure(repeat, [&]() {
+        int64_t total = 0;
+        for (auto& r : records) {
+            if (r.day >= first_day && r.day <= last_day && r.account == account) {
+                total += r.amount;
+            }
+        }
+        sink = total;
+    });
+
+    auto kernel_masked = measure(repeat, [&]() { sink = budget::masked_sum(days.data(), accounts.data(), amounts.data(), n, first_day, last_day, account); });
+
+    report("date and account sum", records_masked, kernel_masked);
+
+    return 0;
+}
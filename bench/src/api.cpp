@@ -0,0 +1,123 @@
+//=======================================================================
+// Copyright (c) 2013-2020 Baptiste Wicht.
+// Distributed under the terms of the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+// Benchmark of the requests in server mode against a local server:
+// api_get() on the pooled connections against a new connection for each
+// request, like api_get() did before the pool
+
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include <filesystem>
+namespace fs = std::filesystem;
+
+#include "api.hpp"
+#include "config.hpp"
+#include "http.hpp"
+#include "utils.hpp"
+
+namespace {
+
+template <typename Functor>
+double measure(size_t repeat, Functor functor) {
+    auto start = std::chrono::steady_clock::now();
+
+    for (size_t i = 0; i < repeat; ++i) {
+        functor();
+    }
+
+    auto end = std::chrono::steady_clock::now();
+
+    return std::chrono::duration<double, std::micro>(end - start).count() / repeat;
+}
+
+// A GET on a new connection, without the pool
+bool unpooled_get(const std::string& api) {
+    httplib::Client cli(budget::config_value("server_url").c_str(), budget::to_number<size_t>(budget::config_value("server_port")));
+
+    std::string api_complete = "/api" + api;
+
+    httplib::Request req;
+    req.method = "GET";
+    req.path   = api_complete.c_str();
+
+    req.set_header("Accept", "*/*");
+    req.set_header("User-Agent", "cpp-httplib/0.1");
+
+    httplib::Response res;
+    return cli.send(req, res) && res.status == 200;
+}
+
+volatile bool sink;
+
+} // end of anonymous namespace
+
+int main(int argc, char** argv) {
+    size_t repeat = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1000;
+
+    httplib::Server server;
+
+    server.Get("/api/server/up/", [](const httplib::Request&, httplib::Response& res) {
+        res.set_content("yes", "text/plain");
+    });
+
+    int port = server.bind_to_any_port("localhost");
+
+    std::thread thread([&server]() { server.listen_after_bind(); });
+
+    // The configuration is only read from a file, so the bench uses its
+    // own configuration and data directory
+    auto folder = fs::temp_directory_path() / "budget_bench";
+    fs::create_directories(folder / "budget");
+
+    {
+        std::ofstream config(folder / "budget" / "budgetrc");
+        config << "directory=" << folder.string() << std::endl;
+        config << "server_mode=true" << std::endl;
+        config << "server_url=localhost" << std::endl;
+        config << "server_port=" << port << std::endl;
+        config << "server_secure=false" << std::endl;
+    }
+
+    setenv("XDG_CONFIG_HOME", folder.c_str(), 1);
+
+    if (budget::config_file() != (folder / "budget" / "budgetrc").string()) {
+        std::cout << "The configuration in " << budget::config_file() << " would be used, cannot run the bench" << std::endl;
+        server.stop();
+        thread.join();
+        return 1;
+    }
+
+    if (!budget::load_config()) {
+        std::cout << "Unable to load the bench configuration" << std::endl;
+        server.stop();
+        thread.join();
+        return 1;
+    }
+
+    std::cout << "GET requests to a local server, " << repeat << " times" << std::endl;
+
+    auto unpooled = measure(repeat, []() { sink = unpooled_get("/server/up/"); });
+    auto pooled   = measure(repeat, []() { sink = budget::api_get("/server/up/").success; });
+
+    auto statistics = budget::get_api_statistics();
+
+    std::cout << "api_get: new connections " << unpooled << "us, pooled " << pooled << "us, speedup " << unpooled / pooled << "x" << std::endl;
+    std::cout << "api_get: " << statistics.connections << " connections opened for " << statistics.requests << " pooled requests ("
+              << statistics.failures << " failed)" << std::endl;
+
+    server.stop();
+    thread.join();
+
+    fs::remove_all(folder);
+
+    return 0;
+}
@@ -0,0 +1,53 @@
+//=======================================================================
+// Copyright (c) 2013-2020 Baptiste Wicht.
+// Distributed under the terms of the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "accounts.hpp"
+#include "span.hpp"
+
+namespace budget {
+
+/*!
+ * \brief An index of the versions of the accounts by date.
+ *
+ * The since and until dates of all the versions split the time in
+ * intervals during which the same versions are active. For each interval,
+ * the active versions are stored contiguously (in the order of the data)
+ * so that they can be returned without allocation.
+ */
+struct account_index {
+    explicit account_index(const std::vector<account>& accounts);
+
+    /*!
+     * \brief Return the versions active at the given date
+     */
+    span<account> active(budget::date date) const;
+
+    /*!
+     * \brief Return the version of the given account active at the given
+     * date, or nullptr if there is none.
+     */
+    const account* find(const std::string& name, budget::date date) const;
+
+private:
+    size_t interval(budget::date date) const;
+
+    // Interval 0 is before the first boundary, interval 2k + 1 is the
+    // boundary k itself and interval 2k + 2 is between the boundaries k
+    // and k + 1
+    std::vector<budget::date> boundaries;
+
+    std::vector<account> versions;  // The active versions of each interval
+    std::vector<size_t> offsets;    // The start of each interval in versions
+    std::vector<size_t> by_name;    // The positions in versions, sorted by name in each interval
+};
+
+} //end of namespace budget
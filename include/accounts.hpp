@@ -7,11 +7,14 @@
 
 #pragma once
 
+#include <array>
 #include <vector>
 #include <string>
 #include <map>
 
 #include "module_traits.hpp"
+#include "data_snapshot.hpp"
+#include "span.hpp"
 #include "money.hpp"
 #include "date.hpp"
 #include "writer_fwd.hpp"
@@ -22,7 +25,6 @@ struct data_reader;
 struct data_writer;
 
 struct accounts_module {
-    void load();
     void unload();
     void handle(const std::vector<std::string>& args);
 };
@@ -31,6 +33,8 @@ template<>
 struct module_traits<accounts_module> {
     static constexpr const bool is_default = false;
     static constexpr const char* command = "account";
+
+    static constexpr const std::array<const char*, 3> needs = {{"accounts", "expenses", "earnings"}};
 };
 
 struct account {
@@ -56,11 +60,14 @@ std::vector<std::string> all_account_names();
 
 struct data_cache;
 
-std::vector<budget::account> all_accounts();
-std::vector<budget::account> all_accounts(data_cache & cache, year year, month month);
-std::vector<budget::account> current_accounts(data_cache & cache);
+data_snapshot<budget::account> all_accounts();
+span<budget::account> all_accounts(data_cache & cache, year year, month month);
+span<budget::account> current_accounts(data_cache & cache);
 
-budget::account get_account(size_t id);
+/*!
+ * \brief Return the account with the given id, without copying it
+ */
+data_entry<budget::account> get_account(size_t id);
 budget::account get_account(std::string name, year year, month month);
 
 void set_accounts_changed();
@@ -0,0 +1,57 @@
+//=======================================================================
+// Copyright (c) 2013-2020 Baptiste Wicht.
+// Distributed under the terms of the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace budget {
+
+// Account value matching all the accounts in the masked sums
+constexpr uint32_t any_account = 0xFFFFFFFF;
+
+/*!
+ * \brief Return the sum of the n given amounts.
+ */
+int64_t sum_amounts(const int64_t* amounts, size_t n);
+
+/*!
+ * \brief Return the sum of the amounts of the given account (or of all
+ * the accounts with any_account).
+ */
+int64_t masked_sum(const uint32_t* accounts, const int64_t* amounts, size_t n, uint32_t account);
+
+/*!
+ * \brief Return the sum of the amounts whose day is between first_day and
+ * last_day (inclusive) and whose account is the given account (or of all
+ * the accounts with any_account).
+ */
+int64_t masked_sum(const uint32_t* days, const uint32_t* accounts, const int64_t* amounts, size_t n, uint32_t first_day, uint32_t last_day, uint32_t account);
+
+/*!
+ * \brief Accumulate amounts into per-account and per-month buckets, in a
+ * single pass.
+ *
+ * The days must be sorted. month_starts contains the day numbers of the
+ * start of each month, plus the end of the last month. The amount i is
+ * added to buckets[account_rows[accounts[i]] * months + month], with
+ * months = month_starts.size() - 1. The amounts outside of the months or
+ * of an account without row (outside of account_rows or with any_account
+ * as row) are ignored.
+ */
+void histogram(const uint32_t* days, const uint32_t* accounts, const int64_t* amounts, size_t n,
+               const std::vector<uint32_t>& month_starts, const std::vector<uint32_t>& account_rows, int64_t* buckets);
+
+/*!
+ * \brief Return the name of the kernels selected for this processor
+ * ("avx2", "sse2" or "scalar").
+ */
+const char* aggregation_kernels();
+
+} //end of namespace budget
@@ -7,6 +7,7 @@
 
 #pragma once
 
+#include <chrono>
 #include <string>
 #include <utility>
 #include <map>
@@ -21,4 +22,20 @@ struct api_response {
 api_response api_get(const std::string& api);
 api_response api_post(const std::string& api, const std::map<std::string, std::string>& params);
 
+/*!
+ * \brief The statistics of the requests made to the server
+ */
+struct api_statistics {
+    size_t requests;                         ///< The number of requests
+    size_t failures;                         ///< The number of failed requests
+    size_t connections;                      ///< The number of connections opened
+    std::chrono::microseconds total_latency; ///< The sum of the latencies of the requests
+    std::chrono::microseconds max_latency;   ///< The highest latency of a request
+};
+
+/*!
+ * \brief Return the statistics of the requests made so far
+ */
+api_statistics get_api_statistics();
+
 } //end of namespace budget
@@ -7,11 +7,13 @@
 
 #pragma once
 
+#include <array>
 #include <vector>
 #include <string>
 #include <map>
 
 #include "module_traits.hpp"
+#include "data_snapshot.hpp"
 #include "money.hpp"
 #include "date.hpp"
 #include "writer_fwd.hpp"
@@ -24,7 +26,6 @@ struct data_reader;
 struct data_writer;
 
 struct assets_module {
-    void load();
     void unload();
     void handle(const std::vector<std::string>& args);
 };
@@ -33,6 +34,8 @@ template<>
 struct module_traits<assets_module> {
     static constexpr const bool is_default = false;
     static constexpr const char* command = "asset";
+
+    static constexpr const std::array<const char*, 1> needs = {{"assets"}};
 };
 
 // An asset class
@@ -47,7 +50,7 @@ struct asset_class {
     void save(data_writer & writer);
 };
 
-budget::asset_class get_asset_class(size_t id);
+data_entry<budget::asset_class> get_asset_class(size_t id);
 budget::asset_class get_asset_class(const std::string & name);
 
 // An asset
@@ -85,11 +88,11 @@ struct asset {
 
     bool is_cash() const {
         for (auto& [class_id, alloc] : classes) {
-            if (get_asset_class(class_id).name == "cash") {
+            if (get_asset_class(class_id)->name == "cash") {
                 return alloc == budget::money(100);
             }
 
-            if (get_asset_class(class_id).name == "Cash") {
+            if (get_asset_class(class_id)->name == "Cash") {
                 return alloc == budget::money(100);
             }
         }
@@ -167,7 +170,7 @@ bool asset_class_exists(const std::string& name);
 bool asset_exists(const std::string& asset);
 bool share_asset_exists(const std::string& asset);
 
-budget::asset get_asset(size_t id);
+data_entry<budget::asset> get_asset(size_t id);
 budget::asset get_asset(std::string name);
 
 budget::asset_value get_asset_value(size_t id);
@@ -175,10 +178,10 @@ budget::asset_share get_asset_share(size_t id);
 
 budget::asset get_desired_allocation();
 
-std::vector<budget::asset_class> all_asset_classes();
-std::vector<budget::asset> all_assets();
-std::vector<budget::asset_value> all_asset_values();
-std::vector<budget::asset_share> all_asset_shares();
+data_snapshot<budget::asset_class> all_asset_classes();
+data_snapshot<budget::asset> all_assets();
+data_snapshot<budget::asset_value> all_asset_values();
+data_snapshot<budget::asset_share> all_asset_shares();
 
 budget::date asset_start_date(data_cache& cache);
 budget::date asset_start_date(data_cache& cache, const asset& asset);
@@ -237,7 +240,7 @@ budget::money get_asset_value_conv(const budget::asset & asset, const std::strin
 budget::money get_asset_value_conv(const budget::asset & asset, budget::date d, const std::string& currency, data_cache & cache);
 
 // Utilities for assets
-void update_asset_class_allocation(budget::asset& asset, budget::asset_class & clas, budget::money alloc);
+void update_asset_class_allocation(budget::asset& asset, const budget::asset_class & clas, budget::money alloc);
 budget::money get_asset_class_allocation(const budget::asset& asset, const budget::asset_class & clas);
 
 } //end of namespace budget
@@ -0,0 +1,100 @@
+//=======================================================================
+// Copyright (c) 2013-2020 Baptiste Wicht.
+// Distributed under the terms of the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace budget {
+
+struct date;
+struct money;
+struct data_writer;
+
+/*!
+ * \brief The type of a field written by a data_writer, which is also
+ * the type of a column in the columnar format.
+ */
+enum class data_type : uint8_t {
+    BOOL   = 1,
+    SIZE_T = 2,
+    INT64  = 3,
+    INT32  = 4,
+    STRING = 5,
+    DATE   = 6,
+    MONEY  = 7
+};
+
+/*!
+ * \brief Read-only access to a columnar data file.
+ *
+ * A columnar file stores one fixed-width column per field (ids, packed
+ * dates, money cents, ...) and one offset column plus a heap for each
+ * string field. The file is memory-mapped so that loading a module does
+ * not need to parse anything.
+ */
+struct columnar_file {
+    /*!
+     * \brief Open the given file.
+     *
+     * A file that is not a columnar file is not valid. A columnar file
+     * that is truncated or corrupted throws a budget_exception.
+     */
+    explicit columnar_file(const std::string& path);
+    ~columnar_file();
+
+    // The mapping should never be copied
+    columnar_file(const columnar_file& rhs) = delete;
+    columnar_file& operator=(const columnar_file& rhs) = delete;
+
+    bool valid() const;
+
+    size_t next_id() const;
+    size_t rows() const;
+    size_t columns() const;
+
+    data_type type(size_t column) const;
+
+    int64_t          read_integer(size_t column, size_t row) const;
+    std::string_view read_string(size_t column, size_t row) const;
+    budget::date     read_date(size_t column, size_t row) const;
+    budget::money    read_money(size_t column, size_t row) const;
+
+private:
+    const char* column_data(size_t column) const;
+    void check(const std::string& path) const;
+    void release();
+
+    const char* data_ = nullptr;
+    size_t size_        = 0;
+    size_t mapped_size_ = 0;
+    bool mapped_        = false;
+
+    std::vector<char> buffer_; // Only used when the file cannot be mapped
+
+    size_t next_id_ = 0;
+    size_t rows_    = 0;
+    size_t columns_ = 0;
+};
+
+/*!
+ * \brief Indicates if the given file is in the columnar format.
+ */
+bool is_columnar_file(const std::string& path);
+
+/*!
+ * \brief Write the given records to a columnar file.
+ *
+ * All the records must have been written with the same sequence of field
+ * types, otherwise nothing is written and false is returned.
+ */
+bool write_columnar_file(const std::string& path, size_t next_id, const std::vector<data_writer>& records);
+
+} //end of namespace budget
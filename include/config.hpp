@@ -29,6 +29,12 @@ std::string config_value(const std::string& key);
 std::string config_value(const std::string& key, const std::string& def);
 bool config_contains_and_true(const std::string& key);
 
+/*!
+ * \brief Override a value of the configuration file, for this process only.
+ */
+void config_set(const std::string& key, const std::string& value);
+void config_remove(const std::string& key);
+
 std::string user_config_value(const std::string& key, const std::string& def);
 bool user_config_value_bool(const std::string& key, bool def);
 
@@ -42,6 +48,14 @@ std::string get_web_password();
 std::string get_server_listen();
 size_t get_server_port();
 
+/*!
+ * \brief Returns the maximum number of prices or exchange rates that
+ * are fetched concurrently.
+ *
+ * This can be changed with fetch_concurrency in the configuration file.
+ */
+size_t get_fetch_concurrency();
+
 /*!
  * \brief Indicates if the server is running in secure mode.
  *
@@ -0,0 +1,143 @@
+//=======================================================================
+// Copyright (c) 2013-2020 Baptiste Wicht.
+// Distributed under the terms of the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace budget {
+
+/*!
+ * \brief A pool of persistent connections to one server.
+ *
+ * A connection is only used by one request at a time. Once the request
+ * is done, the connection goes back to the pool and is reused by the
+ * next request, from any thread, instead of connecting again.
+ */
+template <typename Client>
+struct connection_pool {
+    /*!
+     * \brief A connection borrowed from the pool, given back when destroyed
+     */
+    struct connection {
+        connection(connection_pool& pool, std::unique_ptr<Client> client, bool reused) : pool(pool), client(std::move(client)), reused(reused) {}
+
+        connection(const connection&) = delete;
+        connection& operator=(const connection&) = delete;
+
+        ~connection() {
+            if (client) {
+                pool.release(std::move(client));
+            }
+        }
+
+        Client& operator*() {
+            return *client;
+        }
+
+        Client* operator->() {
+            return client.get();
+        }
+
+        /*!
+         * \brief Indicates if the connection was already used before
+         */
+        bool was_reused() const {
+            return reused;
+        }
+
+        /*!
+         * \brief Close the connection instead of giving it back to the
+         * pool, after an error
+         */
+        void discard() {
+            client.reset();
+        }
+
+    private:
+        connection_pool& pool;
+        std::unique_ptr<Client> client;
+        bool reused;
+    };
+
+    /*!
+     * \brief Create a pool of connections to the given server.
+     *
+     * At most max_idle connections are kept open between requests. A
+     * connection idle for longer than idle_timeout is closed since the
+     * server has likely closed it already.
+     */
+    connection_pool(std::string host, size_t port, size_t max_idle = 8, std::chrono::milliseconds idle_timeout = std::chrono::seconds(3))
+            : host(std::move(host)), port(port), max_idle(max_idle), idle_timeout(idle_timeout) {}
+
+    /*!
+     * \brief Get an idle connection or open a new one
+     */
+    connection acquire() {
+        {
+            std::lock_guard<std::mutex> l(lock);
+
+            auto now = std::chrono::steady_clock::now();
+
+            while (!idle.empty()) {
+                auto [client, last_used] = std::move(idle.back());
+                idle.pop_back();
+
+                if (now - last_used < idle_timeout) {
+                    return connection(*this, std::move(client), true);
+                }
+            }
+        }
+
+        ++opened;
+
+        auto client = std::make_unique<Client>(host.c_str(), port);
+        client->set_keep_alive(true);
+        return connection(*this, std::move(client), false);
+    }
+
+    /*!
+     * \brief Return the number of connections that have been opened
+     */
+    size_t connections() const {
+        return opened;
+    }
+
+    const std::string& server() const {
+        return host;
+    }
+
+    size_t server_port() const {
+        return port;
+    }
+
+private:
+    void release(std::unique_ptr<Client> client) {
+        std::lock_guard<std::mutex> l(lock);
+
+        if (idle.size() < max_idle) {
+            idle.emplace_back(std::move(client), std::chrono::steady_clock::now());
+        }
+    }
+
+    std::string host;
+    size_t port;
+    size_t max_idle;
+    std::chrono::milliseconds idle_timeout;
+
+    std::mutex lock;
+    std::vector<std::pair<std::unique_ptr<Client>, std::chrono::steady_clock::time_point>> idle;
+    std::atomic<size_t> opened{0};
+};
+
+} //end of namespace budget
@@ -312,14 +312,7 @@ struct account_checker {
 
     bool operator()(const std::string& value) {
         data_cache cache;
-
-        for (auto& account : all_accounts(cache, date.year(), date.month())) {
-            if (account.name == value) {
-                return true;
-            }
-        }
-
-        return false;
+        return cache.accounts_index().find(value, budget::date(date.year(), date.month(), 5));
     }
 
     std::string message(){
@@ -8,18 +8,86 @@
 #pragma once
 
 #include <string>
+#include <utility>
+#include <vector>
 
 namespace budget {
 
 struct date;
+struct currency_rates;
 
 double exchange_rate(const std::string& from);
 double exchange_rate(const std::string& from, budget::date d);
 double exchange_rate(const std::string& from, const std::string& to);
 double exchange_rate(const std::string& from, const std::string& to, budget::date d);
 
+/*!
+ * \brief A handle on the exchange rates from one currency to another.
+ *
+ * The pair is looked up once when the handle is created. The rates that
+ * are already in cache are then read without taking any lock.
+ */
+struct currency_pair {
+    /*!
+     * \brief Return the exchange rate at the given date, fetching it if
+     * necessary. The rates of future dates are the rates of today.
+     */
+    double rate(budget::date d) const;
+
+    /*!
+     * \brief Return the last valid exchange rate known at the given date,
+     * fetching the rate of the date itself only if none is known.
+     */
+    double previous_rate(budget::date d) const;
+
+private:
+    explicit currency_pair(currency_rates* rates) : rates(rates) {}
+
+    currency_rates* rates; // nullptr for a currency to itself
+
+    friend currency_pair get_currency_pair(const std::string& from, const std::string& to);
+    friend void prefetch_exchange_rates(const std::vector<std::pair<currency_pair, budget::date>>& rates);
+};
+
+currency_pair get_currency_pair(const std::string& from, const std::string& to);
+
+/*!
+ * \brief Fetch the exchange rates that are not in cache yet for the
+ * given pairs and dates.
+ *
+ * All the missing dates of a pair are fetched with a single request
+ * covering them, which also fills the reverse pair.
+ */
+void prefetch_exchange_rates(const std::vector<std::pair<currency_pair, budget::date>>& rates);
+
+/*!
+ * \brief The server the exchange rates are fetched from
+ */
+struct exchange_rates_server {
+    std::string host;
+    size_t port;
+    bool ssl;
+};
+
+/*!
+ * \brief Fetch the exchange rates from another server than
+ * api.exchangeratesapi.io
+ */
+void set_exchange_rates_server(const std::string& host, size_t port, bool ssl);
+
+/*!
+ * \brief Return the server the exchange rates are currently fetched from
+ */
+exchange_rates_server get_exchange_rates_server();
+
 void load_currency_cache();
 void save_currency_cache();
+
+/*!
+ * \brief Fetch the current exchange rates of all the pairs of the cache.
+ *
+ * This is called by the server when it refreshes its caches.
+ */
 void refresh_currency_cache();
 
 } //end of namespace budget
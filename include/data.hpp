@@ -7,8 +7,22 @@
 
 #pragma once
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <filesystem>
 #include <fstream>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
 #include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
 #include <vector>
 
 #include "cpp_utils/assert.hpp"
@@ -19,6 +33,8 @@
 #include "api.hpp"
 #include "server_lock.hpp"
 #include "budget_exception.hpp"
+#include "columnar.hpp"
+#include "data_snapshot.hpp"
 
 namespace budget {
 
@@ -26,7 +42,8 @@ struct date;
 struct money;
 
 struct data_reader {
-    void parse(const std::string& data);
+    void parse(std::string_view data);
+    void parse(const columnar_file& file, size_t row);
 
     data_reader& operator>>(bool& value);
     data_reader& operator>>(size_t& value);
@@ -42,8 +59,19 @@ struct data_reader {
     std::string peek() const;
 
 private:
-    std::vector<std::string> parts;
-    size_t                   current = 0;
+    std::string part() const;
+    std::string_view view() const;
+    bool integer_column() const;
+
+    // The fields are views inside line, which is reused between records
+    // to avoid allocations. Escaped fields are decoded in place.
+    std::string                   line;
+    std::vector<std::string_view> parts;
+    size_t                        current = 0;
+
+    // When set, the fields are read from this row of a columnar file
+    const columnar_file* columns = nullptr;
+    size_t               row     = 0;
 };
 
 struct data_writer {
@@ -57,29 +85,129 @@ struct data_writer {
 
     std::string to_string() const;
 
+    // Typed access to the fields, used to write the columnar format
+
+    size_t fields() const;
+    data_type field_type(size_t i) const;
+    int64_t field_value(size_t i) const;
+    const std::string& field_text(size_t i) const;
+
 private:
     std::vector<std::string> parts;
+    std::vector<data_type>   types;
+    std::vector<int64_t>     values; // The binary value of the non-string fields
+};
+
+/*!
+ * \brief A batch of changes of a data handler to write to the disk.
+ */
+struct data_batch {
+    bool rewrite   = false;            // Indicates if the whole file must be rewritten
+    size_t next_id = 0;                // The next id, only when rewriting
+    std::vector<data_writer> records;  // All the records, only when rewriting
+    std::vector<std::string> journal;  // The lines to append to the journal otherwise
+};
+
+/*!
+ * \brief Return the path of the journal of the given data file.
+ */
+std::string journal_path(const std::string& file_path);
+
+/*!
+ * \brief Write the batch for the given data file.
+ *
+ * When rewriting, the data is written to a temporary file which is then
+ * renamed over the data file and the journal is removed. Return false if
+ * the batch could not be written.
+ */
+bool write_data_batch(const std::string& file_path, const data_batch& batch, bool columnar, const char* module);
+
+/*!
+ * \brief Writes the changes of a data handler in a background thread while
+ * the server is running.
+ *
+ * Notifications are coalesced: the flush happens once no change happened
+ * for persist_delay milliseconds or at the latest persist_max_latency
+ * milliseconds after the first change.
+ */
+struct persister {
+    explicit persister(std::function<void()> flush);
+    ~persister();
+
+    persister(const persister& rhs) = delete;
+    persister& operator=(const persister& rhs) = delete;
+
+    void notify();
+
+    // Flush the last changes and stop the thread
+    void stop();
+
+private:
+    void run();
+
+    std::function<void()> flush;
+    std::chrono::milliseconds delay;
+    std::chrono::milliseconds max_latency;
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool dirty    = false;
+    bool stopping = false;
+    bool running  = true;
+    std::chrono::steady_clock::time_point first_change;
+    std::chrono::steady_clock::time_point last_change;
+
+    std::thread thread;
 };
 
+/*!
+ * \brief Flush the pending changes of all the data handlers and stop their
+ * background persistence. Must be called before the program exits, the
+ * flush cannot happen safely during the destruction of the handlers.
+ */
+void stop_persistence();
+
+// Files smaller than this are always parsed sequentially
+constexpr size_t parallel_parse_threshold = 1024 * 1024;
+
+// Minimum size of a chunk for parallel parsing
+constexpr size_t parallel_parse_chunk = 256 * 1024;
+
 template<typename T>
 struct data_handler {
     size_t next_id; // Note: No need to protect this since this is only accessed by GC (not run from server)
 
-    data_handler(const char* module, const char* path) : module(module), path(path) {
+    using key_function = std::function<std::string(const T&)>;
+
+    data_handler(const char* module, const char* path) : module(module), path(path), lock(module) {
         // Nothing else to init
     };
 
+    /*!
+     * \brief Construct a data handler with extra indexes on some keys of
+     * the entries (for instance their name).
+     */
+    data_handler(const char* module, const char* path, std::initializer_list<std::pair<const char*, key_function>> keys) : module(module), path(path), lock(module) {
+        for (auto& [name, key] : keys) {
+            key_indexes.push_back({name, key, {}});
+        }
+    };
+
     //data_handler should never be copied
     data_handler(const data_handler& rhs) = delete;
     data_handler& operator=(const data_handler& rhs) = delete;
 
     bool is_changed() const {
-        return changed;
+        return changed || !pending_journal.empty();
     }
 
     void set_changed() {
         server_lock_guard l(lock);
 
+        // The data may have been changed in any way
+        indexes_valid = false;
+        invalidate_snapshot();
+
         set_changed_internal();
     }
 
@@ -87,13 +215,15 @@ struct data_handler {
     void parse_stream(std::istream& file, Functor f){
         next_id = 1;
 
+        // The line and the reader are reused to avoid allocations
         std::string line;
+        data_reader reader;
+
         while (file.good() && getline(file, line)) {
             if (line.empty()) {
                 continue;
             }
 
-            data_reader reader;
             reader.parse(line);
 
             T entry;
@@ -108,11 +238,247 @@ struct data_handler {
         }
     }
 
+    /*!
+     * \brief Parse all the records of the given content.
+     *
+     * When parallel is set and the content is large enough, the content is
+     * split into newline-aligned chunks that are parsed concurrently. The
+     * result is exactly the same as the sequential parsing. At most one
+     * chunk is parsed per thread.
+     */
+    template<typename Functor>
+    void parse_buffer(std::string_view content, Functor f, bool parallel, size_t threads = std::thread::hardware_concurrency()){
+        size_t chunks = std::min<size_t>(threads, content.size() / parallel_parse_chunk);
+
+        // Random mode uses a global generator that cannot be shared
+        if (!parallel || chunks < 2 || content.size() < parallel_parse_threshold || budget::config_contains("random")) {
+            next_id = parse_chunk(content, f, data_) + 1;
+            return;
+        }
+
+        std::vector<std::string_view> parts;
+
+        size_t start = 0;
+        for (size_t i = 1; i <= chunks && start < content.size(); ++i) {
+            size_t end = i == chunks ? content.size() : std::max(start, i * content.size() / chunks);
+
+            // Align the end of the chunk on the next line
+            end = std::min(content.size(), content.find('\n', end));
+
+            if (end < content.size()) {
+                ++end;
+            }
+
+            parts.push_back(content.substr(start, end - start));
+            start = end;
+        }
+
+        std::vector<std::vector<T>> results(parts.size());
+        std::vector<std::future<size_t>> futures;
+
+        for (size_t i = 0; i < parts.size(); ++i) {
+            futures.push_back(std::async(std::launch::async, [&, i]() { return parse_chunk(parts[i], f, results[i]); }));
+        }
+
+        size_t max_id = 0;
+        for (auto& future : futures) {
+            max_id = std::max(max_id, future.get());
+        }
+
+        size_t total = 0;
+        for (auto& result : results) {
+            total += result.size();
+        }
+
+        data_.reserve(data_.size() + total);
+
+        for (auto& result : results) {
+            std::move(result.begin(), result.end(), std::back_inserter(data_));
+        }
+
+        next_id = max_id + 1;
+    }
+
+    // Parse the lines of chunk into entries and return the maximum id
+    template<typename Functor>
+    static size_t parse_chunk(std::string_view chunk, Functor& f, std::vector<T>& entries){
+        size_t max_id = 0;
+
+        data_reader reader;
+
+        while (!chunk.empty()) {
+            auto end  = chunk.find('\n');
+            auto line = chunk.substr(0, end);
+
+            chunk.remove_prefix(end == std::string_view::npos ? chunk.size() : end + 1);
+
+            if (line.empty()) {
+                continue;
+            }
+
+            reader.parse(line);
+
+            T entry;
+
+            f(reader, entry);
+
+            max_id = std::max(max_id, entry.id);
+
+            entries.push_back(std::move(entry));
+        }
+
+        return max_id;
+    }
+
+    template<typename Functor>
+    void parse_columnar(const std::string& file_path, Functor f){
+        next_id = 1;
+
+        columnar_file file(file_path);
+
+        if (!file.valid()) {
+            throw budget_exception("Unable to load " + file_path);
+        }
+
+        data_.reserve(file.rows());
+
+        data_reader reader;
+
+        for (size_t row = 0; row < file.rows(); ++row) {
+            reader.parse(file, row);
+
+            T entry;
+
+            f(reader, entry);
+
+            if (entry.id >= next_id) {
+                next_id = entry.id + 1;
+            }
+
+            data_.push_back(std::move(entry));
+        }
+    }
+
+    /*!
+     * \brief Apply the mutations of the journal on top of the base file.
+     *
+     * Each line of the journal is either A:<record> (add), E:<record> (edit)
+     * or R:<id> (remove). Replaying is idempotent so that a crash between
+     * the compaction of the base file and the removal of the journal is
+     * harmless.
+     */
+    template<typename Functor>
+    void replay_journal(Functor f){
+        pending_journal.clear();
+        journal_size = 0;
+
+        std::ifstream file(journal_path());
+
+        if (!file.is_open()) {
+            return;
+        }
+
+        // The slots of the entries by id, the removed entries are only
+        // erased once the whole journal has been replayed
+        std::unordered_map<size_t, size_t> slots;
+        std::vector<bool> removed(data_.size(), false);
+
+        slots.reserve(data_.size());
+
+        for (size_t slot = 0; slot < data_.size(); ++slot) {
+            slots[data_[slot].id] = slot;
+        }
+
+        std::string line;
+        while (file.good() && getline(file, line)) {
+            // Each line is written with its newline, a last line without it
+            // has been truncated by a crash and is dropped, so that the next
+            // mutations are not appended to it
+            if (file.eof()) {
+                LOG_F(WARNING, "Dropping the truncated last line of {}", journal_path());
+
+                std::error_code ec;
+                std::filesystem::resize_file(journal_path(), journal_size, ec);
+
+                if (ec) {
+                    // The next save rewrites the data and removes the journal
+                    changed = true;
+                }
+
+                break;
+            }
+
+            journal_size += line.size() + 1;
+
+            if (line.size() < 2 || line[1] != ':') {
+                continue;
+            }
+
+            if (line[0] == 'R') {
+                auto id = budget::to_number<size_t>(line.substr(2));
+
+                if (auto it = slots.find(id); it != slots.end()) {
+                    removed[it->second] = true;
+                    slots.erase(it);
+                }
+
+                continue;
+            }
+
+            data_reader reader;
+            reader.parse(line.substr(2));
+
+            T entry;
+
+            f(reader, entry);
+
+            if (entry.id >= next_id) {
+                next_id = entry.id + 1;
+            }
+
+            if (auto it = slots.find(entry.id); it != slots.end()) {
+                data_[it->second] = std::move(entry);
+            } else {
+                slots[entry.id] = data_.size();
+                data_.push_back(std::move(entry));
+                removed.push_back(false);
+            }
+        }
+
+        // Erase the removed entries, keeping the order of the others
+        size_t kept = 0;
+
+        for (size_t slot = 0; slot < data_.size(); ++slot) {
+            if (!removed[slot]) {
+                if (kept != slot) {
+                    data_[kept] = std::move(data_[slot]);
+                }
+
+                ++kept;
+            }
+        }
+
+        data_.erase(data_.begin() + kept, data_.end());
+    }
+
     template<typename Functor>
     void load(Functor f){
+        load(f, false);
+    }
+
+    /*!
+     * \brief Load the data using the given functor to read each entry.
+     *
+     * The functor is only called from several threads when parallel is
+     * set, it must then be safe to call concurrently.
+     */
+    template<typename Functor>
+    void load(Functor f, bool parallel){
         //Make sure to clear the data first, as load_data can be called
         //several times
         data_.clear();
+        indexes_valid = false;
+        invalidate_snapshot();
 
         if(is_server_mode()){
             auto res = budget::api_get(std::string("/") + module + "/list/");
@@ -126,25 +492,39 @@ struct data_handler {
 
             if (!file_exists(file_path)) {
                 next_id = 1;
+            } else if (is_columnar_file(file_path)) {
+                parse_columnar(file_path, f);
             } else {
-                std::ifstream file(file_path);
+                std::ifstream file(file_path, std::ios::binary);
 
                 if (file.is_open()) {
                     if (file.good()) {
+                        std::string content(std::istreambuf_iterator<char>(file), {});
+
                         // We do not use the next_id saved anymore
-                        // Simply consume the line
-                        std::string id_line;
-                        getline(file, id_line);
+                        // Simply skip the first line
+                        std::string_view records(content);
+                        auto id_end = records.find('\n');
+                        records.remove_prefix(id_end == std::string_view::npos ? records.size() : id_end + 1);
 
-                        parse_stream(file, f);
+                        parse_buffer(records, f, parallel);
+
+                        // The text file will be converted on the next save
+                        if (is_columnar_format()) {
+                            changed = true;
+                        }
                     }
                 }
             }
+
+            replay_journal(f);
         }
+
+        invalidate_snapshot();
     }
 
     void load(){
-        load([](data_reader& reader, T& entry){ entry.load(reader); });
+        load([](data_reader& reader, T& entry){ entry.load(reader); }, true);
     }
 
     void save() {
@@ -158,7 +538,7 @@ struct data_handler {
 
         // In other modes, save if it's changed
         if (is_changed()) {
-            force_save();
+            persist();
         }
     }
 
@@ -178,19 +558,34 @@ struct data_handler {
                 return true;
             }
         } else {
-            for (auto& v : data_) {
-                if (v.id == value.id) {
-                    v = value;
+            auto slot = find_slot(value.id);
 
-                    if (propagate) {
-                        set_changed_internal();
-                    }
+            if (slot == data_.size()) {
+                return false;
+            }
+
+            auto& v = data_[slot];
+
+            // The indexes only need to be rebuilt if one of the keys changed
+            if (v.guid != value.guid) {
+                indexes_valid = false;
+            }
 
-                    return true;
+            for (auto& index : key_indexes) {
+                if (index.key(v) != index.key(value)) {
+                    indexes_valid = false;
                 }
             }
 
-            return false;
+            v = value;
+
+            invalidate_snapshot();
+
+            if (propagate) {
+                journal_internal('E', v);
+            }
+
+            return true;
         }
     }
 
@@ -211,13 +606,21 @@ struct data_handler {
                 entry.id = budget::to_number<size_t>(res.result);
 
                 data_.emplace_back(std::forward<TT>(entry));
+
+                index_added();
+                invalidate_snapshot();
             }
         } else {
             entry.id = next_id++;
 
             data_.emplace_back(std::forward<TT>(entry));
 
-            set_changed_internal();
+            index_added();
+            invalidate_snapshot();
+
+            journal_internal('A', data_.back());
+
+            return data_.back().id;
         }
 
         return entry.id;
@@ -227,9 +630,15 @@ struct data_handler {
         server_lock_guard l(lock);
 
         auto before = data_.size();
-        data_.erase(std::remove_if(data_.begin(), data_.end(),
-                                  [id](const T& entry) { return entry.id == id; }),
-                   data_.end());
+        auto slot   = find_slot(id);
+
+        if (slot < data_.size()) {
+            data_.erase(data_.begin() + slot);
+
+            // All the following slots have moved
+            indexes_valid = false;
+            invalidate_snapshot();
+        }
 
         if (is_server_mode()) {
             auto res = budget::api_get(std::string("/") + get_module() + "/delete/?input_id=" + budget::to_string(id));
@@ -240,43 +649,88 @@ struct data_handler {
 
             return res.success;
         } else {
-            set_changed_internal();
+            if (data_.size() < before) {
+                journal_internal("R:" + budget::to_string(id));
+
+                return true;
+            }
 
-            return data_.size() < before;
+            return false;
         }
     }
 
-    bool exists(size_t id) {
-        server_lock_guard l(lock);
+    bool exists(size_t id) const {
+        server_shared_lock_guard l(lock);
 
-        for (auto& entry : data_) {
-            if (entry.id == id) {
-                return true;
-            }
+        return find_slot(id) < data_.size();
+    }
+
+    /*!
+     * \brief Return the entry with the given id.
+     *
+     * The entry is not copied, it is read from a snapshot of the data.
+     */
+    data_entry<T> operator[](size_t id) const {
+        server_shared_lock_guard l(lock);
+
+        auto slot = find_slot(id);
+
+        if (slot < data_.size()) {
+            return data_entry<T>(locked_data(), slot);
         }
 
-        return false;
+        throw budget_exception("There is no data with id " + std::to_string(id) + " in " + module);
     }
 
-    T operator[](size_t id) const {
-        server_lock_guard l(lock);
+    bool guid_exists(const std::string& guid) const {
+        server_shared_lock_guard l(lock);
 
-        for (auto& value : data_) {
-            if (value.id == id) {
-                return value;
-            }
+        ensure_indexes();
+
+        return guid_index.count(guid);
+    }
+
+    T get_by_guid(const std::string& guid) const {
+        server_shared_lock_guard l(lock);
+
+        ensure_indexes();
+
+        if (auto it = guid_index.find(guid); it != guid_index.end()) {
+            return data_[it->second];
         }
 
-        throw budget_exception("There is no data with id " + std::to_string(id) + " in " + module);
+        throw budget_exception("There is no data with guid " + guid + " in " + module);
+    }
+
+    /*!
+     * \brief Return all the entries with the given key in the given index,
+     * in the order of the data.
+     *
+     * The entries are not copied, they are read from a snapshot of the data.
+     */
+    data_matches<T> find(const char* index, const std::string& key) const {
+        server_shared_lock_guard l(lock);
+
+        if (auto* slots = find_slots(index, key)) {
+            return data_matches<T>(locked_data(), *slots);
+        }
+
+        return {};
+    }
+
+    bool contains(const char* index, const std::string& key) const {
+        server_shared_lock_guard l(lock);
+
+        return find_slots(index, key) != nullptr;
     }
 
     size_t size() const {
-        server_lock_guard l(lock);
+        server_shared_lock_guard l(lock);
         return data_.size();
     }
 
     bool empty() const {
-        server_lock_guard l(lock);
+        server_shared_lock_guard l(lock);
         return data_.empty();
     }
 
@@ -284,61 +738,278 @@ struct data_handler {
         return module;
     }
 
-    std::vector<T> data() const {
-        std::vector<T> copy;
-        copy.reserve(size());
-
-        {
-            server_lock_guard l(lock);
-            std::copy(data_.begin(), data_.end(), std::back_inserter(copy));
+    /*!
+     * \brief Return a snapshot of the data.
+     *
+     * The snapshot is only built once after each change, the following
+     * readers share it without copying and without taking the lock.
+     */
+    data_snapshot<T> data() const {
+        if (auto snapshot = std::atomic_load(&snapshot_)) {
+            return make_snapshot(std::move(snapshot));
         }
 
-        return copy;
+        server_shared_lock_guard l(lock);
+
+        return locked_data();
+    }
+
+    /*!
+     * \brief Return the generation of the data.
+     *
+     * The generation is incremented after each change, derived data can
+     * be kept as long as the generation it was computed from is current.
+     */
+    size_t generation() const {
+        return generation_.load();
     }
 
     // This can only be accessed during loading
     std::vector<T> & unsafe_data() {
+        invalidate_snapshot();
         return data_;
     }
 
 private:
+    struct key_index {
+        std::string name;
+        key_function key;
+        std::unordered_map<std::string, std::vector<size_t>> slots;
+    };
+
+    struct published_data {
+        std::vector<T> records;
+        size_t generation;
+    };
+
+    static data_snapshot<T> make_snapshot(std::shared_ptr<const published_data> published) {
+        auto generation = published->generation;
+
+        // The snapshot shares the ownership of the published data
+        return data_snapshot<T>(std::shared_ptr<const std::vector<T>>(published, &published->records), generation);
+    }
+
+    // Return the snapshot of the data, building it if necessary. The lock
+    // must be held, at least in shared mode.
+    data_snapshot<T> locked_data() const {
+        // Another reader may have built it in the meantime
+        auto snapshot = std::atomic_load(&snapshot_);
+
+        if (!snapshot) {
+            snapshot = std::make_shared<const published_data>(published_data{data_, generation_.load()});
+            std::atomic_store(&snapshot_, snapshot);
+        }
+
+        return make_snapshot(std::move(snapshot));
+    }
+
+    // Must be called, under the lock, after any change to the data
+    void invalidate_snapshot() {
+        ++generation_;
+        std::atomic_store(&snapshot_, std::shared_ptr<const published_data>());
+    }
+
+    // The indexes are rebuilt lazily after a change that moved the data.
+    // Readers only hold the lock in shared mode, so the rebuild is done
+    // under its own lock.
+    void ensure_indexes() const {
+        if (indexes_valid.load(std::memory_order_acquire)) {
+            return;
+        }
+
+        std::lock_guard<std::mutex> index_guard(index_lock);
+
+        if (indexes_valid.load(std::memory_order_relaxed)) {
+            return;
+        }
+
+        id_index.clear();
+        guid_index.clear();
+
+        for (auto& index : key_indexes) {
+            index.slots.clear();
+        }
+
+        id_index.reserve(data_.size());
+
+        for (size_t slot = 0; slot < data_.size(); ++slot) {
+            index_entry(slot);
+        }
+
+        indexes_valid.store(true, std::memory_order_release);
+    }
+
+    void index_entry(size_t slot) const {
+        auto& entry = data_[slot];
+
+        id_index[entry.id] = slot;
+        guid_index.emplace(entry.guid, slot);
+
+        for (auto& index : key_indexes) {
+            index.slots[index.key(entry)].push_back(slot);
+        }
+    }
+
+    // Index the last entry, if the indexes are already built
+    void index_added() {
+        if (indexes_valid) {
+            index_entry(data_.size() - 1);
+        }
+    }
+
+    // Return the slot of the entry with the given id or data_.size() if there is none
+    size_t find_slot(size_t id) const {
+        ensure_indexes();
+
+        if (auto it = id_index.find(id); it != id_index.end()) {
+            return it->second;
+        }
+
+        return data_.size();
+    }
+
+    const std::vector<size_t>* find_slots(const char* name, const std::string& key) const {
+        ensure_indexes();
+
+        for (auto& index : key_indexes) {
+            if (index.name == name) {
+                if (auto it = index.slots.find(key); it != index.slots.end()) {
+                    return &it->second;
+                }
+
+                return nullptr;
+            }
+        }
+
+        throw budget_exception(std::string("There is no index ") + name + " in " + module);
+    }
+
     void set_changed_internal() {
+        changed = true;
+
         if (is_server_running()) {
-            force_save();
-        } else {
-            changed = true;
+            schedule_persistence();
         }
     }
 
-    void force_save() {
-        cpp_assert(!is_server_mode(), "force_save() should never be called in server mode");
+    void journal_internal(char operation, T& entry) {
+        data_writer writer;
+        entry.save(writer);
+
+        journal_internal(std::string(1, operation) + ":" + writer.to_string());
+    }
+
+    void journal_internal(std::string line) {
+        pending_journal.push_back(std::move(line));
 
+        if (is_server_running()) {
+            schedule_persistence();
+        }
+    }
+
+    // When the server is running, the changes are written in the background
+    void schedule_persistence() {
+        if (!persistence) {
+            persistence = std::make_unique<persister>([this]() { persist(); });
+        }
+
+        persistence->notify();
+    }
+
+    /*!
+     * \brief Write the pending changes to the disk.
+     *
+     * The changes are collected under the lock but written without it, so
+     * that writers are not waiting for the disk.
+     */
+    void persist() {
+        cpp_assert(!is_server_mode(), "persist() should never be called in server mode");
+
+        std::lock_guard<std::mutex> io_guard(io_lock);
+
+        data_batch batch;
+
+        {
+            server_lock_guard l(lock);
+
+            if (!prepare_batch(batch)) {
+                return;
+            }
+        }
+
+        if (!write_data_batch(path_to_budget_file(path), batch, is_columnar_format(), module)) {
+            // The changes are still in memory, the next save rewrites everything
+            server_lock_guard l(lock);
+            changed = true;
+        }
+    }
+
+    /*!
+     * \brief Collect the pending mutations to append to the journal.
+     *
+     * All the records are collected instead when the data has been changed
+     * directly or when the journal grows past journal_max_size bytes.
+     */
+    bool prepare_batch(data_batch& batch) {
         if (budget::config_contains("random")) {
             LOG_F(ERROR, "Saving is disabled in random mode");
-            return;
+            return false;
         }
 
-        auto file_path = path_to_budget_file(path);
+        size_t pending_size = 0;
+        for (auto& line : pending_journal) {
+            pending_size += line.size() + 1;
+        }
 
-        std::ofstream file(file_path);
+        if (changed || journal_size + pending_size > budget::to_number<size_t>(config_value("journal_max_size", "262144"))) {
+            batch.rewrite = true;
+            batch.next_id = next_id;
+            batch.records.resize(data_.size());
 
-        // We still save the file ID so that it's still compatible with older versions for now
-        file << next_id << std::endl;
+            for (size_t i = 0; i < data_.size(); ++i) {
+                data_[i].save(batch.records[i]);
+            }
 
-        for (auto& entry : data_) {
-            data_writer writer;
-            entry.save(writer);
-            file << writer.to_string() << std::endl;
+            journal_size = 0;
+        } else {
+            batch.journal = std::move(pending_journal);
+            journal_size += pending_size;
         }
 
+        pending_journal.clear();
         changed = false;
+
+        return true;
+    }
+
+    std::string journal_path() const {
+        return budget::journal_path(path_to_budget_file(path));
+    }
+
+    static bool is_columnar_format() {
+        return config_value("data_format", "text") == "binary";
     }
 
     const char* module;
     const char* path;
     volatile bool changed = false;
+    std::vector<std::string> pending_journal; // Mutations not yet appended to the journal
+    size_t journal_size = 0;                  // Size in bytes of the journal on disk
     mutable server_lock lock;
     std::vector<T> data_;
+    mutable std::shared_ptr<const published_data> snapshot_; // Published with atomic operations
+    std::atomic<size_t> generation_{1};                       // Incremented after each change
+
+    mutable std::mutex index_lock;                              // Serializes the lazy rebuild of the indexes
+    mutable std::atomic<bool> indexes_valid{false};
+    mutable std::unordered_map<size_t, size_t> id_index;        // id -> slot in data_
+    mutable std::unordered_map<std::string, size_t> guid_index; // guid -> slot in data_
+    mutable std::vector<key_index> key_indexes;                 // Registered keys -> slots in data_
+
+    std::mutex io_lock; // Serializes the writes to the disk
+
+    // Must be the last member so that it's flushed before the data is destroyed
+    std::unique_ptr<persister> persistence;
 };
 
 } //end of namespace budget
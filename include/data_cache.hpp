@@ -7,8 +7,17 @@
 
 #pragma once
 
+#include <memory>
+#include <unordered_map>
 #include <vector>
 
+#include "data_snapshot.hpp"
+#include "account_index.hpp"
+#include "month_index.hpp"
+#include "month_totals.hpp"
+#include "net_worth.hpp"
+#include "share_positions.hpp"
+#include "transactions.hpp"
 #include "earnings.hpp"
 #include "debts.hpp"
 #include "fortune.hpp"
@@ -23,26 +32,52 @@
 
 namespace budget {
 
+/*!
+ * \brief A consistent view of the data of all the modules.
+ *
+ * The data is taken lazily from the snapshots of the modules. The derived
+ * views (sorted data, groups, ...) are shared by all the caches of the
+ * process and only rebuilt when the generation of their module changes,
+ * so creating a new cache for each computation is cheap.
+ */
 struct data_cache {
-    std::vector<earning> & earnings();
-    std::vector<earning> & sorted_earnings();
-    std::vector<debt> & debts();
-    std::vector<fortune> & fortunes();
-    std::vector<asset_value> & asset_values();
-    std::vector<asset_value> & sorted_asset_values();
-    std::unordered_map<size_t, std::vector<asset_value>> & sorted_group_asset_values(bool liability);
-    std::vector<liability> & liabilities();
-    std::vector<recurring> & recurrings();
-    std::vector<income> & incomes();
-    std::vector<account> & accounts();
-    std::vector<asset_share> & asset_shares();
-    std::vector<asset_class> & asset_classes();
-    std::vector<objective> & objectives();
-    std::vector<expense> & expenses();
-    std::vector<expense> & sorted_expenses();
-    std::vector<asset> & assets();
-    std::vector<asset> & user_assets();
-    std::vector<wish> & wishes();
+    const std::vector<earning> & earnings();
+    const std::vector<earning> & sorted_earnings();
+    const month_index<earning> & earnings_index();
+    const transactions & earning_transactions();
+    const std::vector<debt> & debts();
+    const std::vector<fortune> & fortunes();
+    const std::vector<asset_value> & asset_values();
+    const std::vector<asset_value> & sorted_asset_values();
+    const std::vector<asset_value> & sorted_group_asset_values(size_t asset_id, bool liability);
+    const std::vector<liability> & liabilities();
+    const std::vector<recurring> & recurrings();
+    const std::vector<income> & incomes();
+    const std::vector<account> & accounts();
+    const account_index & accounts_index();
+    const std::vector<asset_share> & asset_shares();
+    const share_positions & asset_share_positions();
+    const std::vector<asset_class> & asset_classes();
+    const std::vector<objective> & objectives();
+    const std::vector<expense> & expenses();
+    const std::vector<expense> & sorted_expenses();
+    const month_index<expense> & expenses_index();
+    const transactions & expense_transactions();
+    const std::vector<asset> & assets();
+    const std::vector<asset> & user_assets();
+    const std::vector<wish> & wishes();
+
+    /*!
+     * \brief Return the totals of the expenses and earnings by account
+     * and by month.
+     */
+    const month_totals & totals();
+
+    /*!
+     * \brief Return the daily positions and the net worth of the assets
+     * and liabilities.
+     */
+    const net_worth_series & net_worth();
 
     data_cache() = default;
 
@@ -51,26 +86,34 @@ struct data_cache {
     data_cache & operator=(const data_cache & cache) = delete;
 
 private:
-    std::vector<earning> earnings_;
-    std::vector<earning> sorted_earnings_;
-    std::vector<debt> debts_;
-    std::vector<fortune> fortunes_;
-    std::vector<asset_value> asset_values_;
-    std::vector<asset_value> sorted_asset_values_;
-    std::unordered_map<size_t, std::vector<asset_value>> sorted_group_asset_values_;
-    std::unordered_map<size_t, std::vector<asset_value>> sorted_group_asset_values_liabilities_;
-    std::vector<liability> liabilities_;
-    std::vector<recurring> recurrings_;
-    std::vector<income> incomes_;
-    std::vector<account> accounts_;
-    std::vector<asset_share> asset_shares_;
-    std::vector<asset_class> asset_classes_;
-    std::vector<objective> objectives_;
-    std::vector<expense> expenses_;
-    std::vector<expense> sorted_expenses_;
-    std::vector<asset> assets_;
-    std::vector<asset> user_assets_;
-    std::vector<wish> wishes_;
+    using asset_value_groups = std::unordered_map<size_t, std::vector<asset_value>>;
+
+    data_snapshot<earning> earnings_;
+    std::shared_ptr<const month_index<earning>> earnings_index_;
+    std::shared_ptr<const transactions> earning_transactions_;
+    data_snapshot<debt> debts_;
+    data_snapshot<fortune> fortunes_;
+    data_snapshot<asset_value> asset_values_;
+    std::shared_ptr<const std::vector<asset_value>> sorted_asset_values_;
+    std::shared_ptr<const asset_value_groups> sorted_group_asset_values_;
+    std::shared_ptr<const asset_value_groups> sorted_group_asset_values_liabilities_;
+    data_snapshot<liability> liabilities_;
+    data_snapshot<recurring> recurrings_;
+    data_snapshot<income> incomes_;
+    data_snapshot<account> accounts_;
+    std::shared_ptr<const account_index> accounts_index_;
+    data_snapshot<asset_share> asset_shares_;
+    std::shared_ptr<const share_positions> asset_share_positions_;
+    data_snapshot<asset_class> asset_classes_;
+    data_snapshot<objective> objectives_;
+    data_snapshot<expense> expenses_;
+    std::shared_ptr<const month_index<expense>> expenses_index_;
+    std::shared_ptr<const transactions> expense_transactions_;
+    data_snapshot<asset> assets_;
+    std::shared_ptr<const std::vector<asset>> user_assets_;
+    data_snapshot<wish> wishes_;
+    std::shared_ptr<const month_totals> totals_;
+    std::shared_ptr<const net_worth_series> net_worth_;
 };
 
 } //end of namespace budget
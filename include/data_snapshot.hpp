@@ -0,0 +1,194 @@
+//=======================================================================
+// Copyright (c) 2013-2020 Baptiste Wicht.
+// Distributed under the terms of the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <vector>
+
+namespace budget {
+
+/*!
+ * \brief An immutable snapshot of the data of a data_handler.
+ *
+ * The snapshot shares the records with the handler and with the other
+ * snapshots, it stays valid (and unchanged) even if the data is modified
+ * afterwards.
+ */
+template <typename T>
+struct data_snapshot {
+    using value_type     = T;
+    using const_iterator = typename std::vector<T>::const_iterator;
+    using iterator       = const_iterator;
+
+    data_snapshot() : data_(empty_data()) {}
+
+    data_snapshot(std::shared_ptr<const std::vector<T>> data, size_t generation) : data_(std::move(data)), generation_(generation) {}
+
+    const_iterator begin() const {
+        return data_->begin();
+    }
+
+    const_iterator end() const {
+        return data_->end();
+    }
+
+    size_t size() const {
+        return data_->size();
+    }
+
+    bool empty() const {
+        return data_->empty();
+    }
+
+    const T& operator[](size_t i) const {
+        return (*data_)[i];
+    }
+
+    const T& front() const {
+        return data_->front();
+    }
+
+    const T& back() const {
+        return data_->back();
+    }
+
+    const std::vector<T>& get() const {
+        return *data_;
+    }
+
+    operator const std::vector<T>&() const {
+        return *data_;
+    }
+
+    /*!
+     * \brief Return the generation of the data this snapshot was taken from.
+     */
+    size_t generation() const {
+        return generation_;
+    }
+
+private:
+    static const std::shared_ptr<const std::vector<T>>& empty_data() {
+        static const std::shared_ptr<const std::vector<T>> empty = std::make_shared<const std::vector<T>>();
+        return empty;
+    }
+
+    std::shared_ptr<const std::vector<T>> data_;
+    size_t generation_ = 0;
+};
+
+/*!
+ * \brief One entry of a snapshot of the data, for instance the result of a
+ * lookup by id.
+ *
+ * The entry is not copied, it is read from the snapshot, which is kept
+ * alive as long as the entry. A copy must be made to modify it.
+ */
+template <typename T>
+struct data_entry {
+    data_entry(data_snapshot<T> snapshot, size_t slot) : snapshot_(std::move(snapshot)), entry_(&snapshot_[slot]) {}
+
+    const T& operator*() const {
+        return *entry_;
+    }
+
+    const T* operator->() const {
+        return entry_;
+    }
+
+    operator const T&() const {
+        return *entry_;
+    }
+
+private:
+    data_snapshot<T> snapshot_;
+    const T* entry_;
+};
+
+/*!
+ * \brief Some entries of a snapshot of the data, for instance the result
+ * of a lookup in an index.
+ *
+ * Only the positions of the entries are stored, the entries themselves
+ * are read from the snapshot.
+ */
+template <typename T>
+struct data_matches {
+    struct const_iterator {
+        using iterator_category = std::forward_iterator_tag;
+        using value_type        = T;
+        using difference_type   = std::ptrdiff_t;
+        using pointer           = const T*;
+        using reference         = const T&;
+
+        const_iterator(const data_matches* matches, size_t i) : matches(matches), i(i) {}
+
+        const T& operator*() const {
+            return (*matches)[i];
+        }
+
+        const T* operator->() const {
+            return &(*matches)[i];
+        }
+
+        const_iterator& operator++() {
+            ++i;
+            return *this;
+        }
+
+        bool operator==(const const_iterator& rhs) const {
+            return i == rhs.i;
+        }
+
+        bool operator!=(const const_iterator& rhs) const {
+            return i != rhs.i;
+        }
+
+    private:
+        const data_matches* matches;
+        size_t i;
+    };
+
+    using iterator = const_iterator;
+
+    data_matches() = default;
+
+    data_matches(data_snapshot<T> snapshot, std::vector<size_t> slots) : snapshot_(std::move(snapshot)), slots_(std::move(slots)) {}
+
+    const_iterator begin() const {
+        return {this, 0};
+    }
+
+    const_iterator end() const {
+        return {this, slots_.size()};
+    }
+
+    size_t size() const {
+        return slots_.size();
+    }
+
+    bool empty() const {
+        return slots_.empty();
+    }
+
+    const T& operator[](size_t i) const {
+        return snapshot_[slots_[i]];
+    }
+
+    const T& front() const {
+        return (*this)[0];
+    }
+
+private:
+    data_snapshot<T> snapshot_;
+    std::vector<size_t> slots_;
+};
+
+} //end of namespace budget
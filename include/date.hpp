@@ -7,6 +7,7 @@
 
 #pragma once
 
+#include <cstdint>
 #include <ctime>
 
 #include "cpp_utils/assert.hpp"
@@ -284,6 +285,37 @@ struct date {
         return is_leap(_year);
     }
 
+    /*!
+     * \brief Return the number of days between 0000-03-01 and this date.
+     *
+     * Dates can be compared and subtracted directly by their day number.
+     */
+    uint32_t day_number() const {
+        uint32_t y   = _year - (_month <= 2);
+        uint32_t era = y / 400;
+        uint32_t yoe = y - era * 400;                         // Year of the era
+        uint32_t mp  = (_month + 9) % 12;                     // Month of the year, starting in March
+        uint32_t doy = (153 * mp + 2) / 5 + _day - 1;         // Day of the year
+        uint32_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy; // Day of the era
+
+        return era * 146097 + doe;
+    }
+
+    /*!
+     * \brief Return the date with the given day number.
+     */
+    static date from_day_number(uint32_t number) {
+        uint32_t era = number / 146097;
+        uint32_t doe = number - era * 146097;
+        uint32_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+        uint32_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+        uint32_t mp  = (5 * doy + 2) / 153;
+        uint32_t d   = doy - (153 * mp + 2) / 5 + 1;
+        uint32_t m   = mp < 10 ? mp + 3 : mp - 9;
+
+        return {date_type(yoe + era * 400 + (m <= 2)), date_type(m), date_type(d)};
+    }
+
     date start_of_year() const {
         return {_year, 1, 1};
     }
@@ -495,23 +527,7 @@ struct date {
     }
 
     int64_t operator-(const date& rhs) const {
-        if(*this == rhs){
-            return 0;
-        }
-
-        if(rhs > *this){
-            return -(rhs - *this);
-        }
-
-        auto x = *this;
-        int64_t d = 0;
-
-        while(x != rhs){
-            x -= days(1);
-            ++d;
-        }
-
-        return d;
+        return int64_t(day_number()) - int64_t(rhs.day_number());
     }
 };
 
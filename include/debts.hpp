@@ -7,11 +7,13 @@
 
 #pragma once
 
+#include <array>
 #include <vector>
 #include <string>
 #include <map>
 
 #include "module_traits.hpp"
+#include "data_snapshot.hpp"
 #include "money.hpp"
 #include "date.hpp"
 #include "writer_fwd.hpp"
@@ -22,7 +24,6 @@ struct data_reader;
 struct data_writer;
 
 struct debt_module {
-    void load();
     void unload();
     void handle(const std::vector<std::string>& args);
 };
@@ -31,6 +32,8 @@ template<>
 struct module_traits<debt_module> {
     static constexpr const bool is_default = false;
     static constexpr const char* command = "debt";
+
+    static constexpr const std::array<const char*, 1> needs = {{"debts"}};
 };
 
 struct debt {
@@ -52,7 +55,7 @@ struct debt {
 void load_debts();
 void save_debts();
 
-std::vector<debt> all_debts();
+data_snapshot<debt> all_debts();
 
 void set_debts_changed();
 void set_debts_next_id(size_t next_id);
@@ -7,11 +7,13 @@
 
 #pragma once
 
+#include <array>
 #include <vector>
 #include <string>
 #include <map>
 
 #include "module_traits.hpp"
+#include "data_snapshot.hpp"
 #include "money.hpp"
 #include "date.hpp"
 #include "writer_fwd.hpp"
@@ -23,7 +25,6 @@ struct data_reader;
 struct data_writer;
 
 struct earnings_module {
-    void load();
     void unload();
     void handle(const std::vector<std::string>& args);
 };
@@ -32,6 +33,8 @@ template<>
 struct module_traits<earnings_module> {
     static constexpr const bool is_default = false;
     static constexpr const char* command = "earning";
+
+    static constexpr const std::array<const char*, 2> needs = {{"earnings", "accounts"}};
 };
 
 struct earning {
@@ -51,7 +54,7 @@ struct earning {
 void load_earnings();
 void save_earnings();
 
-std::vector<earning> all_earnings();
+data_snapshot<earning> all_earnings();
 void add_earning(earning&& earning);
 bool edit_earning(const earning& earning);
 
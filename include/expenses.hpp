@@ -7,11 +7,13 @@
 
 #pragma once
 
+#include <array>
 #include <vector>
 #include <string>
 #include <map>
 
 #include "module_traits.hpp"
+#include "data_snapshot.hpp"
 #include "money.hpp"
 #include "date.hpp"
 #include "writer_fwd.hpp"
@@ -25,7 +27,6 @@ struct data_writer;
 const date TEMPLATE_DATE(1666, 6, 6);
 
 struct expenses_module {
-    void load();
     void unload();
     void handle(const std::vector<std::string>& args);
 };
@@ -34,6 +35,8 @@ template<>
 struct module_traits<expenses_module> {
     static constexpr const bool is_default = false;
     static constexpr const char* command = "expense";
+
+    static constexpr const std::array<const char*, 2> needs = {{"expenses", "accounts"}};
 };
 
 struct expense {
@@ -53,7 +56,7 @@ struct expense {
 void load_expenses();
 void save_expenses();
 
-std::vector<expense> all_expenses();
+data_snapshot<expense> all_expenses();
 void add_expense(expense&& expense);
 bool edit_expense(const expense& expense);
 
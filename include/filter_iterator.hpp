@@ -7,17 +7,79 @@
 
 #pragma once
 
-#include <functional>
+#include <cstddef>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+#include "money.hpp"
 
 namespace budget {
 
+/*!
+ * \brief A filter accepting all the values
+ */
+struct no_filter {
+    template <typename T>
+    constexpr bool operator()(const T& /*value*/) const {
+        return true;
+    }
+};
+
+/*!
+ * \brief An iterator over the values of a vector, either directly or
+ * through a list of positions in the vector.
+ */
 template <typename Type>
+struct record_iterator {
+    using iterator_category = std::forward_iterator_tag;
+    using value_type        = Type;
+    using difference_type   = std::ptrdiff_t;
+    using pointer           = const Type*;
+    using reference         = const Type&;
+    using base_type         = typename std::vector<Type>::const_iterator;
+
+    record_iterator(base_type base) : base(base) {}
+
+    record_iterator(base_type base, const size_t* position) : base(base), position(position) {}
+
+    record_iterator& operator++() {
+        if (position) {
+            ++position;
+        } else {
+            ++base;
+        }
+
+        return *this;
+    }
+
+    bool operator==(const record_iterator& rhs) const {
+        return base == rhs.base && position == rhs.position;
+    }
+
+    bool operator!=(const record_iterator& rhs) const {
+        return !(*this == rhs);
+    }
+
+    reference operator*() const {
+        return position ? base[*position] : *base;
+    }
+
+    pointer operator->() const {
+        return &**this;
+    }
+
+private:
+    base_type base;
+    const size_t* position = nullptr;
+};
+
+template <typename Type, typename Filter = no_filter>
 struct filter_iterator {
     using value_type    = Type;
-    using iterator_type = typename std::vector<value_type>::const_iterator;
+    using iterator_type = record_iterator<value_type>;
 
-    template <typename Filter>
-    filter_iterator(iterator_type first, iterator_type last, Filter filter)
+    filter_iterator(iterator_type first, iterator_type last, const Filter& filter)
             : first(first), last(last), filter(filter) {
         while(this->first != this->last && !this->filter(*this->first)){
             ++this->first;
@@ -36,26 +98,18 @@ struct filter_iterator {
         return *this;
     }
 
-    bool operator==(const filter_iterator& rhs) {
+    bool operator==(const filter_iterator& rhs) const {
         return first == rhs.first;
     }
 
-    bool operator!=(const filter_iterator& rhs) {
+    bool operator!=(const filter_iterator& rhs) const {
         return first != rhs.first;
     }
 
-    decltype(auto) operator*() {
-        return *first;
-    }
-
     decltype(auto) operator*() const {
         return *first;
     }
 
-    decltype(auto) operator->() {
-        return &*first;
-    }
-
     decltype(auto) operator->() const {
         return &*first;
     }
@@ -63,44 +117,75 @@ struct filter_iterator {
 private:
     iterator_type first;
     iterator_type last;
-    std::function<bool(const Type&)> filter;
+    Filter filter;
 };
 
-template<typename Type>
+/*!
+ * \brief A view of the values of a range of a vector that match a filter.
+ *
+ * The filter is a template parameter so that the tests can be inlined.
+ * Without filter, this is simply a view of the range.
+ */
+template <typename Type, typename Filter = no_filter>
 struct filter_view {
-    template <typename Filter>
-    filter_view(const std::vector<Type> & container, Filter filter) : container(container), filter(filter) {}
+    using iterator_type = record_iterator<Type>;
+
+    filter_view(const std::vector<Type> & container, Filter filter = Filter()) : first(container.begin()), last(container.end()), filter(std::move(filter)) {}
+
+    filter_view(iterator_type first, iterator_type last, Filter filter = Filter()) : first(first), last(last), filter(std::move(filter)) {}
+
+    filter_view(typename std::vector<Type>::const_iterator first, typename std::vector<Type>::const_iterator last, Filter filter = Filter())
+            : first(first), last(last), filter(std::move(filter)) {}
 
     auto begin() const {
-        return filter_iterator<Type>(container.begin(), container.end(), filter);
+        return filter_iterator<Type, Filter>(first, last, filter);
     }
 
     auto end() const {
-        return filter_iterator<Type>(container.end(), container.end(), filter);
+        return filter_iterator<Type, Filter>(last, last, filter);
     }
 
     auto to_vector() const {
         std::vector<Type> copy;
 
-        auto it  = this->begin();
-        auto end = this->end();
-
-        while (it != end) {
-            copy.push_back(*it);
-            ++it;
+        for (auto it = first; it != last; ++it) {
+            if (filter(*it)) {
+                copy.push_back(*it);
+            }
         }
 
         return copy;
     }
 
+    /*!
+     * \brief Return the sum of the amounts of the values of the view.
+     */
+    budget::money sum_amount() const {
+        budget::money total;
+
+        for (auto it = first; it != last; ++it) {
+            if (filter(*it)) {
+                total += it->amount;
+            }
+        }
+
+        return total;
+    }
+
 private:
-    const std::vector<Type> & container;
-    std::function<bool (const Type &)> filter;
+    iterator_type first;
+    iterator_type last;
+    Filter filter;
 };
 
 template <typename Type, typename Filter>
-filter_view<Type> make_filter_view(const std::vector<Type> & container, Filter filter){
-    return filter_view<Type>(container, filter);
+filter_view<Type, Filter> make_filter_view(const std::vector<Type> & container, Filter filter){
+    return filter_view<Type, Filter>(container, std::move(filter));
+}
+
+template <typename Type, typename Filter>
+inline budget::money accumulate_amount(const filter_view<Type, Filter>& view){
+    return view.sum_amount();
 }
 
 } //end of namespace budget
@@ -7,11 +7,13 @@
 
 #pragma once
 
+#include <array>
 #include <vector>
 #include <string>
 #include <map>
 
 #include "module_traits.hpp"
+#include "data_snapshot.hpp"
 #include "money.hpp"
 #include "date.hpp"
 #include "writer_fwd.hpp"
@@ -22,7 +24,6 @@ struct data_reader;
 struct data_writer;
 
 struct fortune_module {
-    void load();
     void unload();
     void handle(const std::vector<std::string>& args);
 };
@@ -31,6 +32,8 @@ template<>
 struct module_traits<fortune_module> {
     static constexpr const bool is_default = false;
     static constexpr const char* command = "fortune";
+
+    static constexpr const std::array<const char*, 1> needs = {{"fortunes"}};
 };
 
 struct fortune {
@@ -50,7 +53,7 @@ budget::money current_fortune();
 void load_fortunes();
 void save_fortunes();
 
-std::vector<fortune> all_fortunes();
+data_snapshot<fortune> all_fortunes();
 
 void list_fortunes(budget::writer& w);
 void status_fortunes(budget::writer& w, bool short_view);
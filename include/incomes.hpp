@@ -7,11 +7,13 @@
 
 #pragma once
 
+#include <array>
 #include <vector>
 #include <string>
 #include <map>
 
 #include "module_traits.hpp"
+#include "data_snapshot.hpp"
 #include "money.hpp"
 #include "date.hpp"
 #include "writer_fwd.hpp"
@@ -22,7 +24,6 @@ struct data_reader;
 struct data_writer;
 
 struct incomes_module {
-    void load();
     void unload();
     void handle(const std::vector<std::string>& args);
 };
@@ -31,6 +32,8 @@ template<>
 struct module_traits<incomes_module> {
     static constexpr const bool is_default = false;
     static constexpr const char* command   = "income";
+
+    static constexpr const std::array<const char*, 1> needs = {{"incomes"}};
 };
 
 struct income {
@@ -51,7 +54,7 @@ void save_incomes();
 
 bool income_exists(const std::string& income);
 
-std::vector<budget::income> all_incomes();
+data_snapshot<budget::income> all_incomes();
 
 void set_incomes_changed();
 void set_incomes_next_id(size_t next_id);
@@ -7,11 +7,13 @@
 
 #pragma once
 
+#include <array>
 #include <vector>
 #include <string>
 #include <map>
 
 #include "module_traits.hpp"
+#include "data_snapshot.hpp"
 #include "money.hpp"
 #include "date.hpp"
 #include "writer_fwd.hpp"
@@ -24,7 +26,6 @@ struct data_writer;
 struct data_cache;
 
 struct liabilities_module {
-    void load();
     void unload();
     void handle(const std::vector<std::string>& args);
 };
@@ -33,6 +34,8 @@ template<>
 struct module_traits<liabilities_module> {
     static constexpr const bool is_default = false;
     static constexpr const char* command = "liability";
+
+    static constexpr const std::array<const char*, 2> needs = {{"liabilities", "asset_values"}};
 };
 
 // A liability
@@ -53,10 +56,10 @@ void save_liabilities();
 
 void show_liabilities(budget::writer& w);
 
-budget::liability get_liability(size_t id);
+data_entry<budget::liability> get_liability(size_t id);
 budget::liability get_liability(std::string name);
 
-std::vector<budget::liability> all_liabilities();
+data_snapshot<budget::liability> all_liabilities();
 
 budget::date liability_start_date(data_cache & cache);
 budget::date liability_start_date(data_cache & cache, const liability& liability);
@@ -73,15 +76,15 @@ void liability_delete(size_t id);
 bool no_liabilities();
 
 // The value of a liability in its own currency
-budget::money get_liability_value(budget::liability & liability, data_cache & cache);
-budget::money get_liability_value(budget::liability & liability, budget::date d, data_cache & cache);
+budget::money get_liability_value(const budget::liability & liability, data_cache & cache);
+budget::money get_liability_value(const budget::liability & liability, budget::date d, data_cache & cache);
 
 // The value of a liability in the default currency
-budget::money get_liability_value_conv(budget::liability & liability, data_cache & cache);
-budget::money get_liability_value_conv(budget::liability & liability, budget::date d, data_cache & cache);
+budget::money get_liability_value_conv(const budget::liability & liability, data_cache & cache);
+budget::money get_liability_value_conv(const budget::liability & liability, budget::date d, data_cache & cache);
 
 // The value of a liability in a specific currency
-budget::money get_liability_value_conv(budget::liability & liability, const std::string& currency, data_cache & cache);
-budget::money get_liability_value_conv(budget::liability & liability, budget::date d, const std::string& currency, data_cache & cache);
+budget::money get_liability_value_conv(const budget::liability & liability, const std::string& currency, data_cache & cache);
+budget::money get_liability_value_conv(const budget::liability & liability, budget::date d, const std::string& currency, data_cache & cache);
 
 } //end of namespace budget
@@ -0,0 +1,30 @@
+//=======================================================================
+// Copyright (c) 2013-2020 Baptiste Wicht.
+// Distributed under the terms of the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+#pragma once
+
+#include <array>
+#include <vector>
+
+namespace budget {
+
+/*!
+ * \brief Load the data of the given modules concurrently.
+ *
+ * The modules are identified by the name of their data (accounts,
+ * expenses, ...). Each module is only loaded once, even if it is given
+ * several times. Loading "assets" also loads the asset classes, values and
+ * shares.
+ */
+void load_concurrently(const std::vector<const char*>& modules);
+
+template <size_t N>
+void load_concurrently(const std::array<const char*, N>& modules) {
+    load_concurrently(std::vector<const char*>(modules.begin(), modules.end()));
+}
+
+} //end of namespace budget
@@ -8,6 +8,7 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <ostream>
 
 #include "utils.hpp"
@@ -233,7 +234,7 @@ struct money {
 
 // Official money parsing functions
 std::string money_to_string(const money& amount);
-money money_from_string(std::string money_string);
+money money_from_string(std::string_view money_string);
 
 std::ostream& operator<<(std::ostream& stream, const money& amount);
 
@@ -0,0 +1,179 @@
+//=======================================================================
+// Copyright (c) 2013-2020 Baptiste Wicht.
+// Distributed under the terms of the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+#pragma once
+
+#include <algorithm>
+#include <numeric>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "date.hpp"
+#include "filter_iterator.hpp"
+
+namespace budget {
+
+/*!
+ * \brief An index of dated records (expenses, earnings) by month.
+ *
+ * The records are kept once, sorted by date. The months and the accounts
+ * are lists of positions in these records, ordered by month, and by
+ * account and then by month, so that the records of any range of months
+ * are contiguous. Within a month, the records keep the order of the file.
+ * Looking up a range of months is done in constant time.
+ */
+template <typename T>
+struct month_index {
+    using iterator = record_iterator<T>;
+    using range    = std::pair<iterator, iterator>;
+
+    explicit month_index(const std::vector<T>& values) {
+        std::vector<size_t> order(values.size());
+        std::iota(order.begin(), order.end(), 0);
+
+        std::stable_sort(order.begin(), order.end(), [&values](size_t lhs, size_t rhs) {
+            return values[lhs].date < values[rhs].date;
+        });
+
+        // The position of each record of the file in by_date
+        std::vector<size_t> positions(values.size());
+
+        by_date.reserve(values.size());
+
+        for (size_t i = 0; i < order.size(); ++i) {
+            positions[order[i]] = i;
+            by_date.push_back(values[order[i]]);
+        }
+
+        by_month = std::move(positions);
+
+        std::stable_sort(by_month.begin(), by_month.end(), [this](size_t lhs, size_t rhs) {
+            return month_key(lhs) < month_key(rhs);
+        });
+
+        by_account = by_month;
+
+        std::stable_sort(by_account.begin(), by_account.end(), [this](size_t lhs, size_t rhs) {
+            return by_date[lhs].account < by_date[rhs].account;
+        });
+
+        all = make_partition(by_month, 0, by_month.size());
+
+        for (size_t first = 0; first < by_account.size();) {
+            auto account = by_date[by_account[first]].account;
+            auto last    = first;
+
+            while (last < by_account.size() && by_date[by_account[last]].account == account) {
+                ++last;
+            }
+
+            accounts.emplace(account, make_partition(by_account, first, last));
+
+            first = last;
+        }
+    }
+
+    /*!
+     * \brief Return the records sorted by date.
+     */
+    const std::vector<T>& sorted() const {
+        return by_date;
+    }
+
+    range year(budget::year year) const {
+        return between(year, 1, 12);
+    }
+
+    range month(budget::year year, budget::month month) const {
+        return between(year, month, month);
+    }
+
+    range month(size_t account, budget::year year, budget::month month) const {
+        return between(account, year, month, month);
+    }
+
+    /*!
+     * \brief Return the records between the months sm and month
+     * (inclusive) of the given year.
+     */
+    range between(budget::year year, budget::month sm, budget::month month) const {
+        return lookup(by_month, all, year, sm, month);
+    }
+
+    range between(size_t account, budget::year year, budget::month sm, budget::month month) const {
+        if (auto it = accounts.find(account); it != accounts.end()) {
+            return lookup(by_account, it->second, year, sm, month);
+        }
+
+        return {by_date.end(), by_date.end()};
+    }
+
+private:
+    // The records of the month m of the year first_year + y are between
+    // offsets[y * 12 + m - 1] and offsets[y * 12 + m]
+    struct partition {
+        size_t first_year = 0;
+        size_t years      = 0;
+        std::vector<size_t> offsets;
+    };
+
+    size_t month_key(size_t position) const {
+        return size_t(by_date[position].date.year()) * 12 + by_date[position].date.month();
+    }
+
+    partition make_partition(const std::vector<size_t>& positions, size_t first, size_t last) const {
+        partition p;
+
+        if (first == last) {
+            p.offsets.push_back(first);
+            return p;
+        }
+
+        p.first_year = by_date[positions[first]].date.year();
+        p.years      = by_date[positions[last - 1]].date.year() - p.first_year + 1;
+
+        p.offsets.resize(p.years * 12 + 1, 0);
+
+        // Count the records of each month and then accumulate the counts
+        for (size_t i = first; i < last; ++i) {
+            auto& date = by_date[positions[i]].date;
+            ++p.offsets[slot(p, date.year(), date.month()) + 1];
+        }
+
+        p.offsets[0] = first;
+
+        for (size_t i = 1; i < p.offsets.size(); ++i) {
+            p.offsets[i] += p.offsets[i - 1];
+        }
+
+        return p;
+    }
+
+    static size_t slot(const partition& p, size_t year, size_t month) {
+        return (year - p.first_year) * 12 + (month - 1);
+    }
+
+    range lookup(const std::vector<size_t>& positions, const partition& p, size_t year, size_t sm, size_t month) const {
+        month = std::min<size_t>(month, 12);
+
+        if (!p.years || year < p.first_year || year >= p.first_year + p.years || sm < 1 || sm > month) {
+            return {by_date.end(), by_date.end()};
+        }
+
+        return {iterator(by_date.begin(), positions.data() + p.offsets[slot(p, year, sm)]),
+                iterator(by_date.begin(), positions.data() + p.offsets[slot(p, year, month) + 1])};
+    }
+
+    std::vector<T> by_date;
+    std::vector<size_t> by_month;
+    std::vector<size_t> by_account;
+    partition all;
+    std::unordered_map<size_t, partition> accounts;
+};
+
+} //end of namespace budget
@@ -0,0 +1,75 @@
+//=======================================================================
+// Copyright (c) 2013-2020 Baptiste Wicht.
+// Distributed under the terms of the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+#pragma once
+
+#include <array>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "date.hpp"
+#include "money.hpp"
+
+namespace budget {
+
+struct account;
+struct transactions;
+
+/*!
+ * \brief The totals of the expenses and of the earnings of each month,
+ * for all the accounts, for each account id and for each account name.
+ *
+ * The totals are computed in a single pass over the transactions of the
+ * expenses and of the earnings, a query for a month is then done in
+ * constant time and a query for a range of months is done in O(months).
+ */
+struct month_totals {
+    month_totals(const transactions& expenses, const transactions& earnings, const std::vector<account>& accounts);
+
+    budget::money expenses(budget::year year, budget::month month) const;
+    budget::money expenses_between(budget::year year, budget::month sm, budget::month month) const;
+    budget::money account_expenses(size_t account, budget::year year, budget::month month) const;
+    budget::money account_expenses_between(size_t account, budget::year year, budget::month sm, budget::month month) const;
+    budget::money account_expenses(const std::string& account, budget::year year, budget::month month) const;
+
+    budget::money earnings(budget::year year, budget::month month) const;
+    budget::money earnings_between(budget::year year, budget::month sm, budget::month month) const;
+    budget::money account_earnings(size_t account, budget::year year, budget::month month) const;
+    budget::money account_earnings_between(size_t account, budget::year year, budget::month sm, budget::month month) const;
+    budget::money account_earnings(const std::string& account, budget::year year, budget::month month) const;
+
+    /*!
+     * \brief Return the first month of the given year with an expense or an
+     * earning, or 12 if there are none.
+     */
+    budget::month start_month(budget::year year) const;
+
+private:
+    static constexpr size_t EXPENSES = 0;
+    static constexpr size_t EARNINGS = 1;
+
+    // The totals of a row, with one value per month since first_year
+    using row = std::array<std::vector<budget::money>, 2>;
+
+    void add(const transactions& values, size_t kind, const std::unordered_map<size_t, std::string>& account_names);
+
+    budget::money sum(const row* r, size_t kind, size_t year, size_t sm, size_t month) const;
+
+    const row* find_row(size_t account) const;
+    const row* find_row(const std::string& account) const;
+
+    size_t first_year = 0;
+    size_t years      = 0;
+
+    row all;
+    std::unordered_map<size_t, row> ids;
+    std::unordered_map<std::string, row> names;
+    std::unordered_map<size_t, budget::month> start_months;
+};
+
+} //end of namespace budget
@@ -0,0 +1,100 @@
+//=======================================================================
+// Copyright (c) 2013-2020 Baptiste Wicht.
+// Distributed under the terms of the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "assets.hpp"
+#include "currency.hpp"
+#include "liabilities.hpp"
+#include "share_positions.hpp"
+#include "date.hpp"
+#include "money.hpp"
+
+namespace budget {
+
+/*!
+ * \brief The daily positions of all the assets and liabilities.
+ *
+ * The position of an asset is its value in its own currency or, for a
+ * share-based asset, its number of shares. The positions are computed in
+ * a single sweep over the asset values and the share positions and stored
+ * for each day with a change, so that the position at any date is a
+ * binary search over these days.
+ *
+ * The net worth at a date also needs the exchange rates and the share
+ * prices of that date. It is computed the first time a date is asked and
+ * remembered for the past dates, for which the rates do not change.
+ */
+struct net_worth_series {
+    net_worth_series(const std::vector<asset>& assets, const std::vector<liability>& liabilities,
+                     const std::vector<budget::asset_value>& sorted_asset_values, const share_positions& share_positions);
+
+    /*!
+     * \brief Return the value of the asset in its own currency
+     */
+    budget::money asset_value(const budget::asset& asset, budget::date d) const;
+
+    /*!
+     * \brief Return the value of the liability in its own currency
+     */
+    budget::money liability_value(const budget::liability& liability, budget::date d) const;
+
+    /*!
+     * \brief Return the number of shares of the asset
+     */
+    int64_t asset_shares(const budget::asset& asset, budget::date d) const;
+
+    /*!
+     * \brief Return the net worth, in the default currency
+     */
+    budget::money net_worth(budget::date d) const;
+
+    /*!
+     * \brief Fetch all the exchange rates and share prices needed for the
+     * net worth at the given dates, with as few requests as possible
+     */
+    void prefetch(const std::vector<budget::date>& dates) const;
+
+private:
+    struct row {
+        size_t id;
+        bool liability;
+        bool counted; // Whether the row is part of the net worth
+        bool share_based;
+        std::string ticker;
+        currency_pair rate; // To the default currency
+    };
+
+    int64_t position(size_t row, budget::date d) const;
+    budget::money value(size_t row, budget::date d) const;
+
+    std::vector<row> rows;
+    std::unordered_map<size_t, size_t> asset_rows;
+    std::unordered_map<size_t, size_t> liability_rows;
+
+    // The days with a change, sorted
+    std::vector<uint32_t> days;
+
+    // The positions of all the rows for each day with a change
+    std::vector<int64_t> positions;
+
+    // The net worths already computed, by day number
+    struct cache {
+        std::mutex lock;
+        std::unordered_map<uint32_t, budget::money> values;
+    };
+
+    std::unique_ptr<cache> net_worths = std::make_unique<cache>();
+};
+
+} //end of namespace budget
@@ -7,11 +7,13 @@
 
 #pragma once
 
+#include <array>
 #include <vector>
 #include <string>
 #include <map>
 
 #include "module_traits.hpp"
+#include "data_snapshot.hpp"
 #include "money.hpp"
 #include "compute.hpp"
 #include "date.hpp"
@@ -23,7 +25,6 @@ struct data_reader;
 struct data_writer;
 
 struct objectives_module {
-    void load();
     void unload();
     void handle(const std::vector<std::string>& args);
 };
@@ -34,6 +35,8 @@ struct module_traits<objectives_module> {
     static constexpr const char* command = "goal";
 
     static constexpr const inline std::array<std::pair<const char*, const char*>, 1> aliases = {{{"objective", "goal"}}};
+
+    static constexpr const std::array<const char*, 4> needs = {{"expenses", "earnings", "accounts", "objectives"}};
 };
 
 struct objective {
@@ -59,7 +62,7 @@ void current_monthly_objective_status(budget::writer& w, bool full_align);
 void load_objectives();
 void save_objectives();
 
-std::vector<objective> all_objectives();
+data_snapshot<objective> all_objectives();
 
 void set_objectives_changed();
 void set_objectives_next_id(size_t next_id);
@@ -20,7 +20,6 @@
 namespace budget {
 
 struct overview_module {
-    void load();
     void handle(std::vector<std::string>& args);
 };
 
@@ -30,6 +29,8 @@ struct module_traits<overview_module> {
     static constexpr const char* command = "overview";
 
     static constexpr const std::array<std::pair<const char*, const char*>, 1> aliases = {{{"aggregate", "overview aggregate"}}};
+
+    static constexpr const std::array<const char*, 6> needs = {{"accounts", "incomes", "expenses", "earnings", "fortunes", "assets"}};
 };
 
 void display_local_balance(budget::writer& , budget::year year, bool current = true, bool relaxed = false, bool last = false);
@@ -16,7 +16,6 @@
 namespace budget {
 
 struct predict_module {
-    void load();
     void handle(std::vector<std::string>& args);
 };
 
@@ -24,6 +23,8 @@ template<>
 struct module_traits<predict_module> {
     static constexpr const bool is_default = false;
     static constexpr const char* command = "predict";
+
+    static constexpr const std::array<const char*, 3> needs = {{"accounts", "expenses", "earnings"}};
 };
 
 } //end of namespace budget
@@ -0,0 +1,81 @@
+//=======================================================================
+// Copyright (c) 2013-2020 Baptiste Wicht.
+// Distributed under the terms of the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace budget {
+
+/*!
+ * \brief A cached price: the value of a key (a currency pair or a ticker)
+ * at a day.
+ */
+struct price_record {
+    uint32_t key;  ///< The id of the key in the file
+    uint32_t day;  ///< The day number of the date
+    int64_t value; ///< The raw value (cents or bits of a double)
+};
+
+/*!
+ * \brief A binary file of cached prices.
+ *
+ * The file is made of fixed-size records. The keys are stored once, in
+ * definition records, and the prices only refer to their id. New prices
+ * are appended to the end of the file, so that saving the cache only
+ * writes what changed since it was loaded.
+ */
+struct price_cache_file {
+    explicit price_cache_file(std::string path);
+
+    /*!
+     * \brief Read all the records of the file at once.
+     *
+     * The file is memory-mapped only while it is decoded, the records and
+     * the keys are copied out of it and the mapping is released before
+     * returning. The caches call this the first time a price is needed.
+     *
+     * Return false if the file does not exist or is not a price cache
+     * file, in which case the next append will create it.
+     */
+    bool load(std::vector<price_record>& records);
+
+    /*!
+     * \brief Return the key with the given id
+     */
+    const std::string& key(uint32_t id) const;
+
+    /*!
+     * \brief Return the id of the given key, defining it if necessary
+     */
+    uint32_t key_id(const std::string& key);
+
+    /*!
+     * \brief Append the given records to the file.
+     *
+     * The new keys are defined before the records. If the file is not a
+     * valid price cache, it is replaced.
+     */
+    bool append(const std::vector<price_record>& records);
+
+private:
+    std::string path;
+    std::vector<std::string> keys;
+    std::unordered_map<std::string, uint32_t> ids;
+    size_t written_keys = 0; ///< The number of keys already defined in the file
+    size_t valid_size   = 0; ///< The size of the valid part of the file
+};
+
+/*!
+ * \brief Indicates if the given file is a binary price cache file.
+ */
+bool is_price_cache_file(const std::string& path);
+
+} //end of namespace budget
@@ -0,0 +1,112 @@
+//=======================================================================
+// Copyright (c) 2013-2020 Baptiste Wicht.
+// Distributed under the terms of the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+#pragma once
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "date.hpp"
+#include "money.hpp"
+
+namespace budget {
+
+/*!
+ * \brief A source of share prices.
+ *
+ * The providers must be thread safe, they are queried concurrently and
+ * they must not touch the share price cache.
+ */
+struct share_price_provider {
+    virtual ~share_price_provider() = default;
+
+    /*!
+     * \brief Return the closing prices of the ticker between the two
+     * dates, by date. Nothing is returned for an invalid ticker.
+     */
+    virtual std::map<budget::date, budget::money> quotes(const std::string& ticker, budget::date start, budget::date end) = 0;
+};
+
+/*!
+ * \brief A source of exchange rates.
+ *
+ * The providers must be thread safe, they are queried concurrently and
+ * they must not touch the exchange rates cache.
+ */
+struct exchange_rate_provider {
+    virtual ~exchange_rate_provider() = default;
+
+    /*!
+     * \brief Get the exchange rate at the given date, which is the last
+     * known rate for the days without rate. Return false if there is none.
+     */
+    virtual bool rate(const std::string& from, const std::string& to, budget::date d, double& value) = 0;
+
+    /*!
+     * \brief Return the exchange rates known between the two dates, by date
+     */
+    virtual std::map<budget::date, double> rates(const std::string& from, const std::string& to, budget::date start, budget::date end) = 0;
+};
+
+/*!
+ * \brief Provide share prices and exchange rates from a local file,
+ * without any process or network.
+ *
+ * The file is either a binary price cache file or a CSV file with lines
+ * like "2020-01-02,AAPL,300.35" for the share prices and
+ * "2020-01-02,EUR,CHF,1.0854" for the exchange rates. The text cache
+ * files, separated with ':', can be read as well. The whole file is
+ * loaded the first time a price is asked.
+ */
+struct file_price_provider : share_price_provider, exchange_rate_provider {
+    explicit file_price_provider(std::string path);
+
+    std::map<budget::date, budget::money> quotes(const std::string& ticker, budget::date start, budget::date end) override;
+
+    bool rate(const std::string& from, const std::string& to, budget::date d, double& value) override;
+    std::map<budget::date, double> rates(const std::string& from, const std::string& to, budget::date start, budget::date end) override;
+
+    /*!
+     * \brief Return the number of prices and rates of the file
+     */
+    size_t size();
+
+private:
+    void load();
+    void read_text();
+    void read_binary();
+
+    std::string path;
+    std::once_flag loaded;
+
+    // The values by day number, the raw values for prices
+    std::unordered_map<std::string, std::map<uint32_t, int64_t>> prices; // By ticker
+    std::unordered_map<std::string, std::map<uint32_t, double>> exchanges; // By "from:to"
+};
+
+/*!
+ * \brief Use the given provider for the share prices.
+ *
+ * By default, the provider is chosen with share_price_provider in the
+ * configuration file: yfinance (the default) or file, which reads
+ * share_price_file.
+ */
+void set_share_price_provider(std::shared_ptr<share_price_provider> provider);
+
+/*!
+ * \brief Use the given provider for the exchange rates.
+ *
+ * By default, the provider is chosen with exchange_rate_provider in the
+ * configuration file: exchangeratesapi (the default) or file, which
+ * reads exchange_rate_file.
+ */
+void set_exchange_rate_provider(std::shared_ptr<exchange_rate_provider> provider);
+
+} //end of namespace budget
@@ -12,6 +12,7 @@
 #include <map>
 
 #include "module_traits.hpp"
+#include "data_snapshot.hpp"
 #include "money.hpp"
 #include "date.hpp"
 #include "writer_fwd.hpp"
@@ -54,7 +55,7 @@ void check_for_recurrings();
 void load_recurrings();
 void save_recurrings();
 
-std::vector<recurring> all_recurrings();
+data_snapshot<recurring> all_recurrings();
 
 void set_recurrings_changed();
 void set_recurrings_next_id(size_t next_id);
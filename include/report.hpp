@@ -7,6 +7,7 @@
 
 #pragma once
 
+#include <array>
 #include <vector>
 #include <string>
 
@@ -17,7 +18,6 @@
 namespace budget {
 
 struct report_module {
-    void load();
     void handle(const std::vector<std::string>& args);
 };
 
@@ -25,6 +25,8 @@ template<>
 struct module_traits<report_module> {
     static constexpr const bool is_default = false;
     static constexpr const char* command = "report";
+
+    static constexpr const std::array<const char*, 4> needs = {{"accounts", "expenses", "earnings", "incomes"}};
 };
 
 void report(budget::writer& w, budget::year year, bool filter, const std::string& filter_account);
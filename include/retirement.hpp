@@ -7,6 +7,7 @@
 
 #pragma once
 
+#include <array>
 #include <vector>
 #include <string>
 
@@ -19,7 +20,6 @@ namespace budget {
 struct data_cache;
 
 struct retirement_module {
-    void load();
     void handle(std::vector<std::string>& args);
 };
 
@@ -27,6 +27,8 @@ template<>
 struct module_traits<retirement_module> {
     static constexpr const bool is_default = false;
     static constexpr const char* command   = "retirement";
+
+    static constexpr const std::array<const char*, 4> needs = {{"accounts", "assets", "expenses", "earnings"}};
 };
 
 struct asset_value;
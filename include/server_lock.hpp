@@ -7,16 +7,53 @@
 
 #pragma once
 
+#include <atomic>
+#include <chrono>
+#include <cstdint>
 #include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <vector>
 
 #include "config.hpp"
 
 namespace budget {
 
+/*!
+ * \brief Statistics about the use of a server_lock
+ */
+struct server_lock_stats {
+    std::string name;
+    uint64_t exclusive    = 0; ///< Number of exclusive acquisitions
+    uint64_t shared       = 0; ///< Number of shared acquisitions
+    uint64_t contended    = 0; ///< Number of acquisitions that had to wait
+    uint64_t wait_time_us = 0; ///< Total time spent waiting for the lock
+    uint64_t max_wait_us  = 0; ///< Longest time spent waiting for the lock
+};
+
+/*!
+ * \brief A reader/writer lock that is only taken when the server is running.
+ *
+ * Readers should use server_shared_lock_guard so that they do not exclude
+ * each other, mutators should use server_lock_guard.
+ */
 struct server_lock {
+    explicit server_lock(const char* name = "unnamed");
+    ~server_lock();
+
+    // The lock is registered, it should never be copied
+    server_lock(const server_lock& rhs) = delete;
+    server_lock& operator=(const server_lock& rhs) = delete;
+
     void lock() {
         if (is_server_running()) {
-            mutex_lock.lock();
+            if (!mutex_lock.try_lock()) {
+                auto start = std::chrono::steady_clock::now();
+                mutex_lock.lock();
+                contention(start);
+            }
+
+            exclusive.fetch_add(1, std::memory_order_relaxed);
         }
     }
 
@@ -26,10 +63,61 @@ struct server_lock {
         }
     }
 
+    void lock_shared() {
+        if (is_server_running()) {
+            if (!mutex_lock.try_lock_shared()) {
+                auto start = std::chrono::steady_clock::now();
+                mutex_lock.lock_shared();
+                contention(start);
+            }
+
+            shared.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    void unlock_shared() {
+        if (is_server_running()) {
+            mutex_lock.unlock_shared();
+        }
+    }
+
+    server_lock_stats stats() const;
+
 private:
-    std::mutex mutex_lock;
+    void contention(std::chrono::steady_clock::time_point start) {
+        auto waited = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+        contended.fetch_add(1, std::memory_order_relaxed);
+        wait_time_us.fetch_add(waited, std::memory_order_relaxed);
+
+        auto current = max_wait_us.load(std::memory_order_relaxed);
+        while (uint64_t(waited) > current && !max_wait_us.compare_exchange_weak(current, waited, std::memory_order_relaxed)) {}
+    }
+
+    const char* name;
+    std::shared_mutex mutex_lock;
+
+    std::atomic<uint64_t> exclusive{0};
+    std::atomic<uint64_t> shared{0};
+    std::atomic<uint64_t> contended{0};
+    std::atomic<uint64_t> wait_time_us{0};
+    std::atomic<uint64_t> max_wait_us{0};
 };
 
-using server_lock_guard = std::lock_guard<server_lock>;
+using server_lock_guard        = std::lock_guard<server_lock>;
+using server_shared_lock_guard = std::shared_lock<server_lock>;
+
+/*!
+ * \brief Return the statistics of all the server locks
+ */
+std::vector<server_lock_stats> all_server_lock_stats();
+
+/*!
+ * \brief Log the statistics of the server locks that have been contended.
+ *
+ * This is done when the program exits. The server should also call it
+ * when it shuts down.
+ */
+void log_server_lock_stats();
 
 } //end of namespace budget
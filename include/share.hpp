@@ -8,6 +8,8 @@
 #pragma once
 
 #include <string>
+#include <utility>
+#include <vector>
 
 namespace budget {
 
@@ -19,6 +21,20 @@ money share_price(const std::string& quote, budget::date d);
 
 void load_share_price_cache();
 void save_share_price_cache();
+
+/*!
+ * \brief Fetch the current prices of all the tickers of the cache.
+ *
+ * This is called by the server when it refreshes its caches.
+ */
 void prefetch_share_price_cache();
 
+/*!
+ * \brief Fetch the prices of the given tickers at the given dates.
+ *
+ * The prices that are not cached yet are fetched concurrently, with one
+ * fetch for the nearby dates of a ticker.
+ */
+void prefetch_share_prices(const std::vector<std::pair<std::string, budget::date>>& prices);
+
 } //end of namespace budget
@@ -0,0 +1,84 @@
+//=======================================================================
+// Copyright (c) 2013-2020 Baptiste Wicht.
+// Distributed under the terms of the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "assets.hpp"
+#include "date.hpp"
+#include "money.hpp"
+
+namespace budget {
+
+/*!
+ * \brief The position of a share-based asset after the share
+ * transactions of a date.
+ */
+struct share_position {
+    budget::date date;
+    int64_t shares;         ///< The number of shares held
+    budget::money cost;     ///< The cost basis of the shares held
+    budget::money realized; ///< The gains realized by the sales
+};
+
+/*!
+ * \brief The positions of the share-based assets, by date.
+ *
+ * The share transactions of each asset are sorted by date and summed, so
+ * that the position at any date is a single binary search. The cost
+ * basis uses the average cost of the shares: a sale removes its share of
+ * the cost basis and realizes the difference with its price.
+ */
+struct share_positions {
+    explicit share_positions(const std::vector<asset_share>& asset_shares);
+
+    /*!
+     * \brief Return the position of the asset at the given date, or
+     * nullptr if no shares were bought yet.
+     */
+    const share_position* at(size_t asset_id, budget::date d) const;
+
+    /*!
+     * \brief Return the positions of the asset, sorted by date
+     */
+    const std::vector<share_position>& positions(size_t asset_id) const;
+
+    /*!
+     * \brief Return the number of shares held at the given date
+     */
+    int64_t shares(size_t asset_id, budget::date d) const;
+
+    /*!
+     * \brief Return the cost basis of the shares held at the given date
+     */
+    budget::money cost_basis(size_t asset_id, budget::date d) const;
+
+    /*!
+     * \brief Return the gains realized by the sales up to the given date
+     */
+    budget::money realized_gain(size_t asset_id, budget::date d) const;
+
+    /*!
+     * \brief Return the gains of the shares held at the given date if they
+     * were sold at the given price
+     */
+    budget::money unrealized_gain(size_t asset_id, budget::date d, budget::money price) const;
+
+    /*!
+     * \brief Return the gains of the shares held at the given date at the
+     * share price of the asset at this date
+     */
+    budget::money unrealized_gain(size_t asset_id, budget::date d) const;
+
+private:
+    std::unordered_map<size_t, std::vector<share_position>> assets;
+};
+
+} //end of namespace budget
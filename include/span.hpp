@@ -0,0 +1,64 @@
+//=======================================================================
+// Copyright (c) 2013-2020 Baptiste Wicht.
+// Distributed under the terms of the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace budget {
+
+/*!
+ * \brief A read-only view of contiguous values owned by someone else.
+ */
+template <typename T>
+struct span {
+    using value_type     = T;
+    using const_iterator = const T*;
+    using iterator       = const T*;
+
+    span() = default;
+    span(const T* first, size_t size) : first(first), size_(size) {}
+
+    const T* begin() const {
+        return first;
+    }
+
+    const T* end() const {
+        return first + size_;
+    }
+
+    size_t size() const {
+        return size_;
+    }
+
+    bool empty() const {
+        return !size_;
+    }
+
+    const T& operator[](size_t i) const {
+        return first[i];
+    }
+
+    const T& front() const {
+        return *first;
+    }
+
+    const T& back() const {
+        return first[size_ - 1];
+    }
+
+    std::vector<T> to_vector() const {
+        return {begin(), end()};
+    }
+
+private:
+    const T* first = nullptr;
+    size_t size_   = 0;
+};
+
+} //end of namespace budget
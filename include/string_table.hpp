@@ -0,0 +1,72 @@
+//=======================================================================
+// Copyright (c) 2013-2020 Baptiste Wicht.
+// Distributed under the terms of the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace budget {
+
+using string_id = uint32_t;
+
+/*!
+ * \brief A table of interned strings.
+ *
+ * Each distinct string is stored once and is given a small id that stays
+ * valid for the lifetime of the table. Each id also knows the id of its
+ * lower case version so that strings can be compared without case by
+ * comparing ids.
+ */
+struct string_table {
+    /*!
+     * \brief Return the id of the given string, adding it if necessary
+     */
+    string_id intern(std::string_view value);
+
+    /*!
+     * \brief Return the string with the given id
+     */
+    const std::string& str(string_id id) const;
+
+    /*!
+     * \brief Return the id of the lower case version of the given string.
+     */
+    string_id folded(string_id id) const;
+
+    /*!
+     * \brief Return the number of strings in the table
+     */
+    size_t size() const;
+
+private:
+    struct entry {
+        std::string value;
+        string_id folded;
+    };
+
+    string_id insert(std::string_view value);
+
+    mutable std::shared_mutex lock;
+    std::deque<entry> entries; // A deque never moves its elements
+    std::unordered_map<std::string_view, string_id> ids;
+};
+
+/*!
+ * \brief Return the table of the names shared by the whole process.
+ *
+ * Only the names of the expenses and earnings are interned, when the
+ * transaction columns are built. The table is never purged, so the names
+ * that are edited away stay in it until the process exits.
+ */
+string_table& names();
+
+} //end of namespace budget
@@ -20,7 +20,6 @@
 namespace budget {
 
 struct summary_module {
-    void load();
     void handle(std::vector<std::string>& args);
 };
 
@@ -30,6 +29,8 @@ struct module_traits<summary_module> {
     static constexpr const char* command = "summary";
 
     static constexpr const std::array<std::pair<const char*, const char*>, 1> aliases = {{{"aggregate", "overview aggregate"}}};
+
+    static constexpr const std::array<const char*, 5> needs = {{"accounts", "expenses", "earnings", "objectives", "fortunes"}};
 };
 
 void account_summary(budget::writer& w, budget::month month, budget::year year);
@@ -0,0 +1,127 @@
+//=======================================================================
+// Copyright (c) 2013-2020 Baptiste Wicht.
+// Distributed under the terms of the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "aggregation.hpp"
+#include "date.hpp"
+#include "money.hpp"
+#include "string_table.hpp"
+
+namespace budget {
+
+/*!
+ * \brief A structure-of-arrays copy of transactions (expenses or
+ * earnings), sorted by date.
+ *
+ * Only the fields needed for aggregation are kept, each in its own
+ * contiguous array, so that the aggregation loops do not have to go
+ * through the strings of the records.
+ */
+struct transactions {
+    std::vector<uint32_t> days;         ///< The day number of the dates
+    std::vector<uint32_t> accounts;     ///< The account ids
+    std::vector<int64_t> amounts;       ///< The amounts, in cents
+    std::vector<string_id> names;       ///< The ids of the names in budget::names()
+
+    transactions() = default;
+
+    /*!
+     * \brief Build the columns from records sorted by date
+     */
+    template <typename T>
+    explicit transactions(const std::vector<T>& values) {
+        days.reserve(values.size());
+        accounts.reserve(values.size());
+        amounts.reserve(values.size());
+        names.reserve(values.size());
+
+        // Only intern each distinct name once, to avoid locking the table
+        std::unordered_map<std::string_view, string_id> name_ids;
+
+        for (auto& value : values) {
+            days.push_back(value.date.day_number());
+            accounts.push_back(static_cast<uint32_t>(value.account));
+            amounts.push_back(value.amount.value);
+
+            auto it = name_ids.find(value.name);
+
+            if (it == name_ids.end()) {
+                it = name_ids.emplace(value.name, budget::names().intern(value.name)).first;
+            }
+
+            names.push_back(it->second);
+        }
+    }
+
+    size_t size() const {
+        return days.size();
+    }
+
+    bool empty() const {
+        return days.empty();
+    }
+
+    /*!
+     * \brief Return the range [first, last) of the transactions between
+     * the two given dates (inclusive).
+     */
+    std::pair<size_t, size_t> between(budget::date first, budget::date last) const {
+        auto begin = std::lower_bound(days.begin(), days.end(), first.day_number());
+        auto end   = std::upper_bound(begin, days.end(), last.day_number());
+
+        return {begin - days.begin(), end - days.begin()};
+    }
+
+    /*!
+     * \brief Return the sum of the amounts of the given range.
+     */
+    budget::money sum(std::pair<size_t, size_t> range) const {
+        return from_cents(sum_amounts(amounts.data() + range.first, range.second - range.first));
+    }
+
+    /*!
+     * \brief Return the sum of the amounts of the given range, only for
+     * the given account.
+     */
+    budget::money sum(std::pair<size_t, size_t> range, size_t account) const {
+        auto n = range.second - range.first;
+        return from_cents(masked_sum(accounts.data() + range.first, amounts.data() + range.first, n, static_cast<uint32_t>(account)));
+    }
+
+    /*!
+     * \brief Return the first date, ignoring the given date, or the
+     * default value if there are none.
+     */
+    budget::date first_date(budget::date ignored, budget::date def) const {
+        auto ignored_day = ignored.day_number();
+
+        for (auto day : days) {
+            if (day != ignored_day) {
+                return budget::date::from_day_number(day);
+            }
+        }
+
+        return def;
+    }
+
+private:
+    static budget::money from_cents(int64_t cents) {
+        budget::money m;
+        m.value = cents;
+        return m;
+    }
+};
+
+} //end of namespace budget
@@ -7,11 +7,13 @@
 
 #pragma once
 
+#include <array>
 #include <vector>
 #include <string>
 #include <map>
 
 #include "module_traits.hpp"
+#include "data_snapshot.hpp"
 #include "money.hpp"
 #include "date.hpp"
 #include "writer_fwd.hpp"
@@ -22,7 +24,6 @@ struct data_reader;
 struct data_writer;
 
 struct wishes_module {
-    void load();
     void unload();
     void handle(const std::vector<std::string>& args);
 };
@@ -31,6 +32,8 @@ template<>
 struct module_traits<wishes_module> {
     static constexpr const bool is_default = false;
     static constexpr const char* command = "wish";
+
+    static constexpr const std::array<const char*, 7> needs = {{"expenses", "earnings", "accounts", "assets", "fortunes", "objectives", "wishes"}};
 };
 
 struct wish {
@@ -53,7 +56,7 @@ struct wish {
 void load_wishes();
 void save_wishes();
 
-std::vector<wish> all_wishes();
+data_snapshot<wish> all_wishes();
 
 void set_wishes_changed();
 void set_wishes_next_id(size_t next_id);
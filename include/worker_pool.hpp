@@ -0,0 +1,80 @@
+//=======================================================================
+// Copyright (c) 2013-2020 Baptiste Wicht.
+// Distributed under the terms of the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <future>
+#include <vector>
+
+namespace budget {
+
+/*!
+ * \brief Call f(i) for each i in [0, n) on at most workers threads.
+ *
+ * The calls are distributed dynamically so that a slow call does not hold
+ * back the others. All the calls are done before the first error, if any,
+ * is propagated.
+ */
+template <typename Functor>
+void parallel_for(size_t n, size_t workers, Functor f) {
+    workers = std::min(workers, n);
+
+    if (workers <= 1) {
+        for (size_t i = 0; i < n; ++i) {
+            f(i);
+        }
+
+        return;
+    }
+
+    std::atomic<size_t> next{0};
+
+    auto worker = [&]() {
+        std::exception_ptr error;
+
+        for (size_t i = next++; i < n; i = next++) {
+            try {
+                f(i);
+            } catch (...) {
+                if (!error) {
+                    error = std::current_exception();
+                }
+            }
+        }
+
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    };
+
+    std::vector<std::future<void>> futures;
+
+    for (size_t i = 0; i < workers; ++i) {
+        futures.push_back(std::async(std::launch::async, worker));
+    }
+
+    std::exception_ptr error;
+
+    for (auto& future : futures) {
+        try {
+            future.get();
+        } catch (...) {
+            if (!error) {
+                error = std::current_exception();
+            }
+        }
+    }
+
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+} //end of namespace budget
@@ -0,0 +1,94 @@
+//=======================================================================
+// Copyright (c) 2013-2020 Baptiste Wicht.
+// Distributed under the terms of the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+#include <algorithm>
+
+#include "account_index.hpp"
+
+using namespace budget;
+
+budget::account_index::account_index(const std::vector<account>& accounts) {
+    for (auto& account : accounts) {
+        boundaries.push_back(account.since);
+        boundaries.push_back(account.until);
+    }
+
+    std::sort(boundaries.begin(), boundaries.end());
+    boundaries.erase(std::unique(boundaries.begin(), boundaries.end()), boundaries.end());
+
+    const size_t intervals = 2 * boundaries.size() + 1;
+
+    offsets.reserve(intervals + 1);
+
+    for (size_t i = 0; i < intervals; ++i) {
+        offsets.push_back(versions.size());
+
+        // A version is active at a date strictly inside its bounds
+        auto inside = [&](const budget::account& account) {
+            if (i % 2) {
+                auto& date = boundaries[i / 2];
+                return account.since < date && account.until > date;
+            }
+
+            // Nothing is active before the first since or after the last until
+            if (i == 0 || i / 2 == boundaries.size()) {
+                return false;
+            }
+
+            return account.since <= boundaries[i / 2 - 1] && account.until >= boundaries[i / 2];
+        };
+
+        for (auto& account : accounts) {
+            if (inside(account)) {
+                versions.push_back(account);
+            }
+        }
+
+        auto first = offsets.back();
+
+        for (size_t p = first; p < versions.size(); ++p) {
+            by_name.push_back(p);
+        }
+
+        std::sort(by_name.begin() + first, by_name.end(), [this](size_t lhs, size_t rhs) { return versions[lhs].name < versions[rhs].name; });
+    }
+
+    offsets.push_back(versions.size());
+}
+
+size_t budget::account_index::interval(budget::date date) const {
+    auto it = std::upper_bound(boundaries.begin(), boundaries.end(), date);
+
+    if (it == boundaries.begin()) {
+        return 0;
+    }
+
+    size_t k = (it - boundaries.begin()) - 1;
+
+    return boundaries[k] == date ? 2 * k + 1 : 2 * k + 2;
+}
+
+span<account> budget::account_index::active(budget::date date) const {
+    auto i = interval(date);
+
+    return {versions.data() + offsets[i], offsets[i + 1] - offsets[i]};
+}
+
+const account* budget::account_index::find(const std::string& name, budget::date date) const {
+    auto i = interval(date);
+
+    auto first = by_name.begin() + offsets[i];
+    auto last  = by_name.begin() + offsets[i + 1];
+
+    auto it = std::lower_bound(first, last, name, [this](size_t p, const std::string& name) { return versions[p].name < name; });
+
+    if (it != last && versions[*it].name == name) {
+        return &versions[*it];
+    }
+
+    return nullptr;
+}
@@ -26,7 +26,7 @@ using namespace budget;
 
 namespace {
 
-static data_handler<account> accounts { "accounts", "accounts.data" };
+static data_handler<account> accounts { "accounts", "accounts.data", {{"name", [](const account& a) { return a.name; }}} };
 
 size_t get_account_id(std::string name, budget::year year, budget::month month){
     budget::date date(year, month, 5);
@@ -55,12 +55,6 @@ std::map<std::string, std::string> budget::account::get_params() const {
     return params;
 }
 
-void budget::accounts_module::load(){
-    load_accounts();
-    load_expenses();
-    load_earnings();
-}
-
 void budget::accounts_module::unload(){
     save_accounts();
     save_expenses();
@@ -94,7 +88,9 @@ void budget::archive_accounts_impl(bool month){
             copy.until  = budget::date(2099, 12, 31);
             copy.since  = since_date;
 
-            account.until = until_date;
+            auto archived  = account;
+            archived.until = until_date;
+            accounts.indirect_edit(archived, false);
 
             copies.push_back(std::move(copy));
 
@@ -112,18 +108,20 @@ void budget::archive_accounts_impl(bool month){
         mapping[sources[i]] = id;
     }
 
-    for (auto& expense : all_expenses()) {
+    for (auto expense : all_expenses()) {
         if (expense.date >= since_date) {
             if (mapping.find(expense.account) != mapping.end()) {
                 expense.account = mapping[expense.account];
+                indirect_edit_expense(expense, false);
             }
         }
     }
 
-    for (auto& earning : all_earnings()) {
+    for (auto earning : all_earnings()) {
         if (earning.date >= since_date) {
             if (mapping.find(earning.account) != mapping.end()) {
                 earning.account = mapping[earning.account];
+                indirect_edit_earning(earning, false);
             }
         }
     }
@@ -210,7 +208,7 @@ void budget::accounts_module::handle(const std::vector<std::string>& args){
                 id = get_account(name, today.year(), today.month()).id;
             }
 
-            auto account = accounts[id];
+            budget::account account = accounts[id];
 
             edit_string(account.name, "Name", not_empty_checker());
 
@@ -312,14 +310,14 @@ void budget::accounts_module::handle(const std::vector<std::string>& args){
 
                             destination_account.amount += account.amount;
 
-                            for (auto& expense : all_expenses()) {
+                            for (auto expense : all_expenses()) {
                                 if (expense.account == source_id) {
                                     expense.account = destination_id;
                                     indirect_edit_expense(expense, false);
                                 }
                             }
 
-                            for (auto& earning : all_earnings()) {
+                            for (auto earning : all_earnings()) {
                                 if (earning.account == source_id) {
                                     earning.account = destination_id;
                                     indirect_edit_earning(earning, false);
@@ -389,15 +387,15 @@ void budget::save_accounts(){
     accounts.save();
 }
 
-budget::account budget::get_account(size_t id){
+budget::data_entry<budget::account> budget::get_account(size_t id){
     return accounts[id];
 }
 
 budget::account budget::get_account(std::string name, budget::year year, budget::month month){
     budget::date date(year, month, 5);
 
-    for (auto& account : accounts.data()) {
-        if (account.since < date && account.until > date && account.name == name) {
+    for (auto& account : accounts.find("name", name)) {
+        if (account.since < date && account.until > date) {
             return account;
         }
     }
@@ -428,36 +426,20 @@ void budget::account::load(data_reader & reader){
 }
 
 bool budget::account_exists(const std::string& name){
-    for(auto& account : accounts.data()){
-        if(account.name == name){
-            return true;
-        }
-    }
-
-    return false;
+    return accounts.contains("name", name);
 }
 
-std::vector<account> budget::all_accounts(){
+data_snapshot<account> budget::all_accounts(){
     return accounts.data();
 }
 
-std::vector<budget::account> budget::current_accounts(data_cache & cache){
+span<budget::account> budget::current_accounts(data_cache & cache){
     auto today = budget::local_day();
     return all_accounts(cache, today.year(), today.month());
 }
 
-std::vector<account> budget::all_accounts(data_cache & cache, budget::year year, budget::month month){
-    std::vector<account> accounts;
-
-    budget::date date(year, month, 5);
-
-    for(auto& account : cache.accounts()){
-        if(account.since < date && account.until > date){
-            accounts.push_back(account);
-        }
-    }
-
-    return accounts;
+span<account> budget::all_accounts(data_cache & cache, budget::year year, budget::month month){
+    return cache.accounts_index().active(budget::date(year, month, 5));
 }
 
 void budget::set_accounts_changed(){
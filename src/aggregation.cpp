@@ -0,0 +1,208 @@
+//=======================================================================
+// Copyright (c) 2013-2020 Baptiste Wicht.
+// Distributed under the terms of the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+#include <limits>
+
+#include "aggregation.hpp"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define BUDGET_X86_KERNELS
+#include <immintrin.h>
+#endif
+
+using namespace budget;
+
+namespace {
+
+// When no days are given to the masked sum kernels, only the accounts
+// are compared
+
+int64_t masked_sum_scalar(const uint32_t* days, const uint32_t* accounts, const int64_t* amounts, size_t n, uint32_t first_day, uint32_t last_day, uint32_t account) {
+    int64_t total = 0;
+
+    for (size_t i = 0; i < n; ++i) {
+        bool day_ok     = !days || (days[i] >= first_day && days[i] <= last_day);
+        bool account_ok = account == any_account || accounts[i] == account;
+
+        total += day_ok && account_ok ? amounts[i] : 0;
+    }
+
+    return total;
+}
+
+#ifdef BUDGET_X86_KERNELS
+
+// Unsigned comparisons are done as signed comparisons of biased values
+constexpr int32_t bias = std::numeric_limits<int32_t>::min();
+
+__attribute__((target("sse2")))
+__m128i mask_sse2(const uint32_t* days, const uint32_t* accounts, size_t i, __m128i first, __m128i last, __m128i account, __m128i all_accounts) {
+    __m128i mask = _mm_set1_epi32(-1);
+
+    if (days) {
+        auto d = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(days + i)), _mm_set1_epi32(bias));
+
+        mask = _mm_andnot_si128(_mm_or_si128(_mm_cmpgt_epi32(first, d), _mm_cmpgt_epi32(d, last)), mask);
+    }
+
+    auto a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(accounts + i));
+
+    return _mm_and_si128(mask, _mm_or_si128(_mm_cmpeq_epi32(a, account), all_accounts));
+}
+
+__attribute__((target("sse2")))
+int64_t masked_sum_sse2(const uint32_t* days, const uint32_t* accounts, const int64_t* amounts, size_t n, uint32_t first_day, uint32_t last_day, uint32_t account) {
+    auto first        = _mm_set1_epi32(int32_t(first_day) ^ bias);
+    auto last         = _mm_set1_epi32(int32_t(last_day) ^ bias);
+    auto account_v    = _mm_set1_epi32(int32_t(account));
+    auto all_accounts = _mm_set1_epi32(account == any_account ? -1 : 0);
+
+    auto acc_lo = _mm_setzero_si128();
+    auto acc_hi = _mm_setzero_si128();
+
+    size_t i = 0;
+
+    for (; i + 4 <= n; i += 4) {
+        auto mask = mask_sse2(days, accounts, i, first, last, account_v, all_accounts);
+
+        // Widen the 32-bit masks to 64-bit masks
+        auto mask_lo = _mm_unpacklo_epi32(mask, mask);
+        auto mask_hi = _mm_unpackhi_epi32(mask, mask);
+
+        acc_lo = _mm_add_epi64(acc_lo, _mm_and_si128(mask_lo, _mm_loadu_si128(reinterpret_cast<const __m128i*>(amounts + i))));
+        acc_hi = _mm_add_epi64(acc_hi, _mm_and_si128(mask_hi, _mm_loadu_si128(reinterpret_cast<const __m128i*>(amounts + i + 2))));
+    }
+
+    alignas(16) int64_t lanes[2];
+    _mm_store_si128(reinterpret_cast<__m128i*>(lanes), _mm_add_epi64(acc_lo, acc_hi));
+
+    auto rest_days = days ? days + i : nullptr;
+
+    return lanes[0] + lanes[1] + masked_sum_scalar(rest_days, accounts + i, amounts + i, n - i, first_day, last_day, account);
+}
+
+__attribute__((target("avx2")))
+int64_t masked_sum_avx2(const uint32_t* days, const uint32_t* accounts, const int64_t* amounts, size_t n, uint32_t first_day, uint32_t last_day, uint32_t account) {
+    auto first        = _mm256_set1_epi32(int32_t(first_day) ^ bias);
+    auto last         = _mm256_set1_epi32(int32_t(last_day) ^ bias);
+    auto account_v    = _mm256_set1_epi32(int32_t(account));
+    auto all_accounts = _mm256_set1_epi32(account == any_account ? -1 : 0);
+
+    auto acc_lo = _mm256_setzero_si256();
+    auto acc_hi = _mm256_setzero_si256();
+
+    size_t i = 0;
+
+    for (; i + 8 <= n; i += 8) {
+        __m256i mask = _mm256_set1_epi32(-1);
+
+        if (days) {
+            auto d = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(days + i)), _mm256_set1_epi32(bias));
+
+            mask = _mm256_andnot_si256(_mm256_or_si256(_mm256_cmpgt_epi32(first, d), _mm256_cmpgt_epi32(d, last)), mask);
+        }
+
+        auto a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(accounts + i));
+        mask   = _mm256_and_si256(mask, _mm256_or_si256(_mm256_cmpeq_epi32(a, account_v), all_accounts));
+
+        // Sign-extend the 32-bit masks to 64-bit masks
+        auto mask_lo = _mm256_cvtepi32_epi64(_mm256_castsi256_si128(mask));
+        auto mask_hi = _mm256_cvtepi32_epi64(_mm256_extracti128_si256(mask, 1));
+
+        acc_lo = _mm256_add_epi64(acc_lo, _mm256_and_si256(mask_lo, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(amounts + i))));
+        acc_hi = _mm256_add_epi64(acc_hi, _mm256_and_si256(mask_hi, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(amounts + i + 4))));
+    }
+
+    alignas(32) int64_t lanes[4];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), _mm256_add_epi64(acc_lo, acc_hi));
+
+    auto rest_days = days ? days + i : nullptr;
+
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3] + masked_sum_scalar(rest_days, accounts + i, amounts + i, n - i, first_day, last_day, account);
+}
+
+#endif
+
+using masked_sum_kernel = int64_t (*)(const uint32_t*, const uint32_t*, const int64_t*, size_t, uint32_t, uint32_t, uint32_t);
+
+struct kernels {
+    masked_sum_kernel masked_sum = masked_sum_scalar;
+    const char* name             = "scalar";
+
+    kernels() {
+#ifdef BUDGET_X86_KERNELS
+        __builtin_cpu_init();
+
+        if (__builtin_cpu_supports("avx2")) {
+            masked_sum = masked_sum_avx2;
+            name       = "avx2";
+        } else if (__builtin_cpu_supports("sse2")) {
+            masked_sum = masked_sum_sse2;
+            name       = "sse2";
+        }
+#endif
+    }
+};
+
+const kernels& selected_kernels() {
+    static const kernels selected;
+    return selected;
+}
+
+} // end of anonymous namespace
+
+int64_t budget::sum_amounts(const int64_t* amounts, size_t n) {
+    // This is simple enough to be vectorized by the compiler
+    int64_t total = 0;
+
+    for (size_t i = 0; i < n; ++i) {
+        total += amounts[i];
+    }
+
+    return total;
+}
+
+int64_t budget::masked_sum(const uint32_t* accounts, const int64_t* amounts, size_t n, uint32_t account) {
+    if (account == any_account) {
+        return sum_amounts(amounts, n);
+    }
+
+    return selected_kernels().masked_sum(nullptr, accounts, amounts, n, 0, 0, account);
+}
+
+int64_t budget::masked_sum(const uint32_t* days, const uint32_t* accounts, const int64_t* amounts, size_t n, uint32_t first_day, uint32_t last_day, uint32_t account) {
+    return selected_kernels().masked_sum(days, accounts, amounts, n, first_day, last_day, account);
+}
+
+void budget::histogram(const uint32_t* days, const uint32_t* accounts, const int64_t* amounts, size_t n,
+                       const std::vector<uint32_t>& month_starts, const std::vector<uint32_t>& account_rows, int64_t* buckets) {
+    if (month_starts.size() < 2) {
+        return;
+    }
+
+    const size_t months = month_starts.size() - 1;
+
+    size_t i = 0;
+
+    // Skip the amounts before the first month
+    while (i < n && days[i] < month_starts.front()) {
+        ++i;
+    }
+
+    // Since the days are sorted, each month is a contiguous run
+    for (size_t m = 0; m < months; ++m) {
+        for (; i < n && days[i] < month_starts[m + 1]; ++i) {
+            if (accounts[i] < account_rows.size() && account_rows[accounts[i]] != any_account) {
+                buckets[account_rows[accounts[i]] * months + m] += amounts[i];
+            }
+        }
+    }
+}
+
+const char* budget::aggregation_kernels() {
+    return selected_kernels().name;
+}
@@ -5,6 +5,8 @@
 //  http://opensource.org/licenses/MIT)
 //=======================================================================
 
+#include <atomic>
+#include <chrono>
 #include <iostream>
 #include <fstream>
 #include <sstream>
@@ -15,24 +17,19 @@
 #include "config.hpp"
 #include "utils.hpp"
 #include "http.hpp"
+#include "connection_pool.hpp"
 #include "logging.hpp"
 
 namespace {
 
-template<typename Cli>
-budget::api_response base_api_get(Cli& cli, const std::string& api) {
-    auto server      = budget::config_value("server_url");
-    auto server_port = budget::config_value("server_port");
-
-    std::string api_complete = "/api" + api;
-
-    httplib::Request req;
-    req.method = "GET";
-    req.path = api_complete.c_str();
-
-    req.set_header("Accept", "*/*");
-    req.set_header("User-Agent", "cpp-httplib/0.1");
+// The statistics of the requests, the latencies are in microseconds
+std::atomic<size_t> requests{0};
+std::atomic<size_t> failures{0};
+std::atomic<size_t> connections{0};
+std::atomic<size_t> total_latency{0};
+std::atomic<size_t> max_latency{0};
 
+void set_authorization(httplib::Request& req) {
     if (budget::is_secure()) {
         auto user = budget::get_web_user();
         auto password = budget::get_web_password();
@@ -40,40 +37,25 @@ budget::api_response base_api_get(Cli& cli, const std::string& api) {
         std::string authorization = "Basic " + budget::base64_encode(user + ":" + password);
         req.set_header("Authorization", authorization.c_str());
     }
+}
 
-    auto base_res = std::make_shared<httplib::Response>();
-
-    std::shared_ptr<httplib::Response> res;
-    if (cli.send(req, *base_res)) {
-        res = base_res;
-    } else {
-        res = nullptr;
-    }
+httplib::Request get_request(const std::string& api_complete) {
+    httplib::Request req;
+    req.method = "GET";
+    req.path = api_complete.c_str();
 
-    if (!res) {
-        LOG_F(ERROR, "Request from the API failed: No response from server");
-        LOG_F(ERROR, "API: {}:{}/{}", server, server_port, api_complete);
+    req.set_header("Accept", "*/*");
+    req.set_header("User-Agent", "cpp-httplib/0.1");
 
-        return {false, ""};
-    } else if (res->status != 200) {
-        LOG_F(ERROR, "Request from the API failed");
-        LOG_F(ERROR, "API: {}:{}/{}", server, server_port, api_complete);
-        LOG_F(ERROR, "Status: {}", res->status);
-        LOG_F(ERROR, "Content: {}", res->body);
+    set_authorization(req);
 
-        return {false, ""};
-    } else {
-        return {true, res->body};
-    }
+    return req;
 }
 
-template<typename Cli>
-budget::api_response base_api_post(Cli& cli, const std::string& api, const std::map<std::string, std::string>& params) {
+httplib::Request post_request(const std::string& api_complete, const std::map<std::string, std::string>& params) {
     auto server      = budget::config_value("server_url");
     auto server_port = budget::config_value("server_port");
 
-    std::string api_complete = "/api" + api;
-
     std::string query;
     for (auto & [key, value] : params) {
         if (!query.empty()) {
@@ -97,39 +79,84 @@ budget::api_response base_api_post(Cli& cli, const std::string& api, const std::
     req.set_header("Accept", "*/*");
     req.set_header("User-Agent", "cpp-httplib/0.1");
 
-    if (budget::is_secure()) {
-        auto user = budget::get_web_user();
-        auto password = budget::get_web_password();
-
-        req.set_header("Authorization", ("Basic " + budget::base64_encode(user + ":" + password)).c_str());
-    }
+    set_authorization(req);
 
     req.set_header("Content-Type", "application/x-www-form-urlencoded");
     req.body = query;
 
-    auto base_res = std::make_shared<httplib::Response>();
+    return req;
+}
 
-    std::shared_ptr<httplib::Response> res;
-    if (cli.send(req, *base_res)) {
-        res = base_res;
-    } else {
-        res = nullptr;
+// The connections to the server are shared by all the requests
+template<typename Cli>
+budget::connection_pool<Cli>& pool() {
+    static budget::connection_pool<Cli> pool(budget::config_value("server_url"), budget::to_number<size_t>(budget::config_value("server_port")));
+    return pool;
+}
+
+// Send the request on a pooled connection. When retry is set, a request
+// that failed on a reused connection, that the server may have closed in
+// the meantime, is sent again on another connection. This is only safe
+// for requests without side effects.
+template<typename Cli>
+bool send(const httplib::Request& req, httplib::Response& res, bool retry) {
+    while (true) {
+        auto cli = pool<Cli>().acquire();
+
+        if (!cli.was_reused()) {
+            ++connections;
+        }
+
+        if (cli->send(req, res)) {
+            return true;
+        }
+
+        cli.discard();
+
+        if (!retry || !cli.was_reused()) {
+            return false;
+        }
+
+        res = httplib::Response();
     }
+}
+
+template<typename Cli>
+budget::api_response send_request(const httplib::Request& req, bool retry) {
+    auto start = std::chrono::steady_clock::now();
+
+    httplib::Response res;
+    bool sent = send<Cli>(req, res, retry);
+
+    size_t latency = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+
+    ++requests;
+    total_latency += latency;
+
+    size_t previous = max_latency;
+    while (latency > previous && !max_latency.compare_exchange_weak(previous, latency)) {}
+
+    auto& server = pool<Cli>().server();
+    auto server_port = pool<Cli>().server_port();
+
+    if (!sent) {
+        ++failures;
 
-    if (!res) {
         LOG_F(ERROR, "Request from the API failed: No response from server");
-        LOG_F(ERROR, "API: {}:{}/{}", server, server_port, api_complete);
+        LOG_F(ERROR, "API: {}:{}/{}", server, server_port, req.path);
 
         return {false, ""};
-    } else if (res->status != 200) {
+    } else if (res.status != 200) {
+        ++failures;
+
         LOG_F(ERROR, "Request from the API failed");
-        LOG_F(ERROR, "API: {}:{}/{}", server, server_port, api_complete);
-        LOG_F(ERROR, "Status: {}", res->status);
-        LOG_F(ERROR, "Content: {}", res->body);
+        LOG_F(ERROR, "API: {}:{}/{}", server, server_port, req.path);
+        LOG_F(ERROR, "Status: {}", res.status);
+        LOG_F(ERROR, "Content: {}", res.body);
 
         return {false, ""};
     } else {
-        return {true, res->body};
+        return {true, res.body};
     }
 }
 
@@ -138,33 +165,35 @@ budget::api_response base_api_post(Cli& cli, const std::string& api, const std::
 budget::api_response budget::api_get(const std::string& api) {
     cpp_assert(is_server_mode(), "api_get() should only be called in server mode");
 
-    auto server      = config_value("server_url");
-    auto server_port = config_value("server_port");
+    auto req = get_request("/api" + api);
 
     if (is_server_ssl()) {
-        httplib::SSLClient cli(server.c_str(), budget::to_number<size_t>(server_port));
-
-        return base_api_get(cli, api);
+        return send_request<httplib::SSLClient>(req, true);
     } else {
-        httplib::Client cli(server.c_str(), budget::to_number<size_t>(server_port));
-
-        return base_api_get(cli, api);
+        return send_request<httplib::Client>(req, true);
     }
 }
 
 budget::api_response budget::api_post(const std::string& api, const std::map<std::string, std::string>& params) {
     cpp_assert(is_server_mode(), "api_post() should only be called in server mode");
 
-    auto server      = config_value("server_url");
-    auto server_port = config_value("server_port");
+    auto req = post_request("/api" + api, params);
 
     if(is_server_ssl()){
-        httplib::SSLClient cli(server.c_str(), budget::to_number<size_t>(server_port));
-
-        return base_api_post(cli, api, params);
+        return send_request<httplib::SSLClient>(req, false);
     } else {
-        httplib::Client cli(server.c_str(), budget::to_number<size_t>(server_port));
-
-        return base_api_post(cli, api, params);
+        return send_request<httplib::Client>(req, false);
     }
 }
+
+budget::api_statistics budget::get_api_statistics() {
+    api_statistics statistics;
+
+    statistics.requests      = requests;
+    statistics.failures      = failures;
+    statistics.connections   = connections;
+    statistics.total_latency = std::chrono::microseconds(total_latency);
+    statistics.max_latency   = std::chrono::microseconds(max_latency);
+
+    return statistics;
+}
@@ -17,7 +17,7 @@ using namespace budget;
 
 namespace {
 
-static data_handler<asset_class> asset_classes { "asset_classes", "asset_classes.data" };
+static data_handler<asset_class> asset_classes { "asset_classes", "asset_classes.data", {{"name", [](const asset_class& c) { return c.name; }}} };
 
 } //end of anonymous namespace
 
@@ -39,15 +39,13 @@ void budget::save_asset_classes() {
     asset_classes.save();
 }
 
-budget::asset_class budget::get_asset_class(size_t id){
+budget::data_entry<budget::asset_class> budget::get_asset_class(size_t id){
     return asset_classes[id];
 }
 
 budget::asset_class budget::get_asset_class(const std::string & name){
-    for (auto& c : asset_classes.data()) {
-        if (c.name == name) {
-            return c;
-        }
+    if (auto matches = asset_classes.find("name", name); !matches.empty()) {
+        return matches.front();
     }
 
     cpp_unreachable("The asset class does not exist");
@@ -75,7 +73,7 @@ bool budget::asset_class_exists(const std::string& name){
     return false;
 }
 
-std::vector<asset_class> budget::all_asset_classes(){
+data_snapshot<asset_class> budget::all_asset_classes(){
     return asset_classes.data();
 }
 
@@ -134,7 +132,7 @@ size_t budget::add_asset_class(budget::asset_class& asset){
     return asset_classes.add(asset);
 }
 
-void budget::update_asset_class_allocation(budget::asset& asset, budget::asset_class & clas, budget::money alloc) {
+void budget::update_asset_class_allocation(budget::asset& asset, const budget::asset_class & clas, budget::money alloc) {
     for (auto & [class_id, class_alloc] : asset.classes) {
         if (class_id == clas.id) {
             class_alloc = alloc;
@@ -77,7 +77,7 @@ void budget::asset_share::load(data_reader & reader){
     }
 }
 
-std::vector<asset_share> budget::all_asset_shares(){
+data_snapshot<asset_share> budget::all_asset_shares(){
     return asset_shares.data();
 }
 
@@ -125,7 +125,7 @@ void budget::list_asset_shares(budget::writer& w){
     // Display the asset values
 
     for (auto& value : asset_shares.data()) {
-        contents.push_back({to_string(value.id), get_asset(value.asset_id).name,
+        contents.push_back({to_string(value.id), get_asset(value.asset_id)->name,
                             to_string(value.shares), to_string(value.date), to_string(value.price),
                             "::edit::asset_shares::" + budget::to_string(value.id)});
     }
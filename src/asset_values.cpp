@@ -83,7 +83,7 @@ void budget::asset_value::load(data_reader & reader){
     }
 }
 
-std::vector<asset_value> budget::all_asset_values(){
+data_snapshot<asset_value> budget::all_asset_values(){
     return asset_values.data();
 }
 
@@ -133,9 +133,9 @@ void budget::list_asset_values(budget::writer& w, bool liability){
     for(auto& value : asset_values.data()){
         if (value.liability == liability) {
             if (liability) {
-                contents.push_back({to_string(value.id), get_liability(value.asset_id).name, to_string(value.amount), to_string(value.set_date), "::edit::asset_values::" + budget::to_string(value.id)});
+                contents.push_back({to_string(value.id), get_liability(value.asset_id)->name, to_string(value.amount), to_string(value.set_date), "::edit::asset_values::" + budget::to_string(value.id)});
             } else {
-                contents.push_back({to_string(value.id), get_asset(value.asset_id).name, to_string(value.amount), to_string(value.set_date), "::edit::asset_values::" + budget::to_string(value.id)});
+                contents.push_back({to_string(value.id), get_asset(value.asset_id)->name, to_string(value.amount), to_string(value.set_date), "::edit::asset_values::" + budget::to_string(value.id)});
             }
         }
     }
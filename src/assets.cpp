@@ -30,7 +30,7 @@ using namespace budget;
 
 namespace {
 
-static data_handler<asset> assets { "assets", "assets.data" };
+static data_handler<asset> assets { "assets", "assets.data", {{"name", [](const asset& a) { return a.name; }}} };
 
 std::vector<std::string> get_asset_names(data_cache& cache) {
     std::vector<std::string> asset_names;
@@ -76,10 +76,6 @@ std::map<std::string, std::string> budget::asset::get_params() const {
     return params;
 }
 
-void budget::assets_module::load(){
-    load_assets();
-}
-
 void budget::assets_module::unload(){
     save_assets();
 }
@@ -168,7 +164,7 @@ void budget::assets_module::handle(const std::vector<std::string>& args){
 
             auto asset = get_asset(id);
 
-            if (asset.name == "DESIRED" && asset.currency == "DESIRED") {
+            if (asset->name == "DESIRED" && asset->currency == "DESIRED") {
                 throw budget_exception("Cannot delete special asset " + args[2]);
             }
 
@@ -201,7 +197,7 @@ void budget::assets_module::handle(const std::vector<std::string>& args){
                 id = get_asset(name).id;
             }
 
-            auto asset = assets[id];
+            budget::asset asset = assets[id];
 
             edit_string(asset.name, "Name", not_empty_checker());
 
@@ -286,7 +282,7 @@ void budget::assets_module::handle(const std::vector<std::string>& args){
                         throw budget_exception("This asset class does not exist");
                     }
 
-                    auto clas = get_asset_class(id);
+                    budget::asset_class clas = get_asset_class(id);
 
                     edit_string(clas.name, "Name", not_empty_checker());
 
@@ -372,7 +368,7 @@ void budget::assets_module::handle(const std::vector<std::string>& args){
                         throw budget_exception("Cannot edit liability value from the asset module");
                     }
 
-                    std::string asset_name = get_asset(value.asset_id).name;
+                    std::string asset_name = get_asset(value.asset_id)->name;
                     edit_string_complete(asset_name, "Asset", get_asset_names(w.cache), not_empty_checker(), asset_checker());
                     value.asset_id = get_asset(asset_name).id;
 
@@ -448,7 +444,7 @@ void budget::assets_module::handle(const std::vector<std::string>& args){
 
                     auto share = get_asset_share(id);
 
-                    std::string asset_name = get_asset(share.asset_id).name;
+                    std::string asset_name = get_asset(share.asset_id)->name;
                     edit_string_complete(asset_name, "Asset", get_share_asset_names(w.cache), not_empty_checker(), share_asset_checker());
                     share.asset_id = get_asset(asset_name).id;
 
@@ -515,15 +511,13 @@ void budget::save_assets(){
     save_asset_shares();
 }
 
-budget::asset budget::get_asset(size_t id){
+budget::data_entry<budget::asset> budget::get_asset(size_t id){
     return assets[id];
 }
 
 budget::asset budget::get_asset(std::string name){
-    for(auto& asset : assets.data()){
-        if(asset.name == name){
-            return asset;
-        }
+    if (auto matches = assets.find("name", name); !matches.empty()) {
+        return matches.front();
     }
 
     cpp_unreachable("The asset does not exist");
@@ -671,26 +665,18 @@ void budget::asset::load(data_reader & reader){
 }
 
 bool budget::asset_exists(const std::string& name){
-    for (auto& asset : assets.data()) {
-        if (asset.name == name) {
-            return true;
-        }
-    }
-
-    return false;
+    return assets.contains("name", name);
 }
 
 bool budget::share_asset_exists(const std::string& name){
-    for (auto& asset : assets.data()) {
-        if (asset.name == name) {
-            return asset.share_based;
-        }
+    if (auto matches = assets.find("name", name); !matches.empty()) {
+        return matches.front().share_based;
     }
 
     return false;
 }
 
-std::vector<asset> budget::all_assets(){
+data_snapshot<asset> budget::all_assets(){
     return assets.data();
 }
 
@@ -698,10 +684,8 @@ budget::date budget::asset_start_date(data_cache & cache, const budget::asset& a
     budget::date start = budget::local_day();
 
     if (asset.share_based) {
-        for (auto & share : cache.asset_shares()) {
-            if (share.asset_id == asset.id) {
-                start = std::min(share.date, start);
-            }
+        if (auto& positions = cache.asset_share_positions().positions(asset.id); !positions.empty()) {
+            start = std::min(positions.front().date, start);
         }
    } else {
        for (auto & value : cache.asset_values()) {
@@ -1244,17 +1228,7 @@ budget::money budget::get_net_worth(data_cache & cache){
 }
 
 budget::money budget::get_net_worth(budget::date d, data_cache & cache) {
-    budget::money total;
-
-    for (auto & asset : cache.user_assets()) {
-        total += get_asset_value_conv(asset, d, cache);
-    }
-
-    for (auto & asset : cache.liabilities()) {
-        total -= get_liability_value_conv(asset, d, cache);
-    }
-
-    return total;
+    return cache.net_worth().net_worth(d);
 }
 
 budget::money budget::get_net_worth_cash(){
@@ -1271,45 +1245,8 @@ budget::money budget::get_net_worth_cash(){
     return total;
 }
 
-// OPTIM get_asset_value is the current hotspot for almost all pages
-// 1) If the share_based part becomes a bottleneck, we can apply the same
-//    optimization than for the asset value part
-// 2) If this becomes too high, we can also store the value an asset id for each
-//    possible date (in one pass of all asset values of an asset)
-
 budget::money budget::get_asset_value(const budget::asset & asset, budget::date d, data_cache & cache) {
-    if (cpp_unlikely(asset.share_based)) {
-        int64_t shares = 0;
-
-        for (auto& asset_share : cache.asset_shares()) {
-            if (asset_share.asset_id == asset.id) {
-                if (asset_share.date <= d) {
-                    shares += asset_share.shares;
-                }
-            }
-        }
-
-        if (shares > 0) {
-            return static_cast<int>(shares) * share_price(asset.ticker, d);
-        }
-    } else {
-        budget::money asset_value_amount;
-
-        auto & asset_values = cache.sorted_group_asset_values(false)[asset.id];
-
-        if (!asset_values.empty()) {
-            auto it = std::upper_bound(asset_values.begin(), asset_values.end(), d, [](budget::date d, auto & value) { return d < value.set_date; });
-
-            if (it != asset_values.begin()) {
-                --it;
-                asset_value_amount = it->amount;
-            }
-        }
-
-        return asset_value_amount;
-    }
-
-    return {};
+    return cache.net_worth().asset_value(asset, d);
 }
 
 budget::money budget::get_asset_value(const budget::asset & asset, data_cache & cache) {
@@ -14,10 +14,13 @@
 #include "config.hpp"
 #include "args.hpp"
 #include "budget_exception.hpp"
+#include "data.hpp"
 #include "api.hpp"
 #include "currency.hpp"
 #include "share.hpp"
 #include "logging.hpp"
+#include "server_lock.hpp"
+#include "loader.hpp"
 
 //The different modules
 #include "debts.hpp"
@@ -114,6 +117,18 @@ struct has_aliases<Module, std::enable_if_t<has_aliases_field<module_traits<Modu
     static const bool value = true;
 };
 
+HAS_STATIC_FIELD(needs, has_needs_field)
+
+template<typename Module, typename Enable = void>
+struct has_needs {
+    static const bool value = false;
+};
+
+template<typename Module>
+struct has_needs<Module, std::enable_if_t<has_needs_field<module_traits<Module>>::value>> {
+    static const bool value = true;
+};
+
 struct module_loader {
     template<typename Module, cpp::enable_if_u<need_preloading<Module>::value> = cpp::detail::dummy>
     inline void preload(){
@@ -150,6 +165,16 @@ struct module_runner {
         //NOP
     }
 
+    template<typename Module, cpp::enable_if_u<has_needs<Module>::value> = cpp::detail::dummy>
+    inline void load_needs(){
+        budget::load_concurrently(module_traits<Module>::needs);
+    }
+
+    template<typename Module, cpp::disable_if_u<has_needs<Module>::value> = cpp::detail::dummy>
+    inline void load_needs(){
+        //NOP
+    }
+
     template<typename Module, cpp::enable_if_u<need_unloading<Module>::value> = cpp::detail::dummy>
     inline void unload(Module& module){
        module.unload();
@@ -170,6 +195,8 @@ struct module_runner {
 
         Module module;
 
+        // The data needed by the module are loaded concurrently
+        load_needs<Module>();
         load(module);
 
         module.handle(args);
@@ -344,11 +371,25 @@ int main(int argc, const char* argv[]) {
         code = 2;
     }
 
+    // Write the last changes before anything is destroyed
+    stop_persistence();
+
+    log_server_lock_stats();
+
     // Save the caches
     save_currency_cache();
     save_share_price_cache();
 
     save_config();
 
+    if (is_server_mode()) {
+        auto statistics = get_api_statistics();
+
+        if (statistics.requests) {
+            LOG_F(INFO, "API: {} requests ({} failed) on {} connections", statistics.requests, statistics.failures, statistics.connections);
+            LOG_F(INFO, "API: average latency {}us, max latency {}us", statistics.total_latency.count() / statistics.requests, statistics.max_latency.count());
+        }
+    }
+
     return code;
 }
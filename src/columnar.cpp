@@ -0,0 +1,398 @@
+//=======================================================================
+// Copyright (c) 2013-2020 Baptiste Wicht.
+// Distributed under the terms of the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+#include <cstring>
+#include <fstream>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "columnar.hpp"
+#include "data.hpp"
+#include "date.hpp"
+#include "money.hpp"
+#include "logging.hpp"
+#include "budget_exception.hpp"
+
+using namespace budget;
+
+namespace {
+
+// Layout of a columnar file (all integers are native-endian):
+//
+// header  : magic (8 bytes), next_id (u64), rows (u64), columns (u64)
+// columns : for each column, type (u64), offset (u64), size (u64)
+// data    : for each column, its data, aligned on 8 bytes
+//
+// Fixed-width columns are stored as arrays of one value per row:
+//  * BOOL           -> u8
+//  * INT32          -> i32
+//  * SIZE_T / INT64 -> i64
+//  * DATE           -> u32 (year << 16 | month << 8 | day)
+//  * MONEY          -> i64 (cents)
+//
+// String columns are stored as rows + 1 offsets (u64) into a heap of
+// characters that directly follows the offsets.
+
+constexpr const char columnar_magic[8] = {'B', 'U', 'D', 'G', 'E', 'T', 'C', '1'};
+
+struct columnar_header {
+    char     magic[8];
+    uint64_t next_id;
+    uint64_t rows;
+    uint64_t columns;
+};
+
+struct column_entry {
+    uint64_t type;
+    uint64_t offset;
+    uint64_t size;
+};
+
+size_t column_width(data_type type) {
+    switch (type) {
+        case data_type::BOOL:
+            return 1;
+        case data_type::INT32:
+        case data_type::DATE:
+            return 4;
+        case data_type::SIZE_T:
+        case data_type::INT64:
+        case data_type::MONEY:
+            return 8;
+        case data_type::STRING:
+            return 0;
+    }
+
+    return 0;
+}
+
+size_t align(size_t offset) {
+    return (offset + 7) & ~size_t(7);
+}
+
+template <typename T>
+T read_raw(const char* data) {
+    T value;
+    std::memcpy(&value, data, sizeof(T));
+    return value;
+}
+
+template <typename T>
+void append_raw(std::string& out, T value) {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+} // end of anonymous namespace
+
+budget::columnar_file::columnar_file(const std::string& path) {
+#ifndef _WIN32
+    int fd = ::open(path.c_str(), O_RDONLY);
+
+    if (fd >= 0) {
+        struct stat st;
+
+        if (::fstat(fd, &st) == 0 && st.st_size > 0) {
+            void* mapping = ::mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+            if (mapping != MAP_FAILED) {
+                data_        = static_cast<const char*>(mapping);
+                size_        = st.st_size;
+                mapped_size_ = st.st_size;
+                mapped_      = true;
+            }
+        }
+
+        ::close(fd);
+    }
+#endif
+
+    // If the file could not be mapped, we simply read it in memory
+    if (!mapped_) {
+        std::ifstream file(path, std::ios::binary);
+
+        if (file.is_open()) {
+            buffer_.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+            data_ = buffer_.data();
+            size_ = buffer_.size();
+        }
+    }
+
+    if (size_ < sizeof(columnar_header) || std::memcmp(data_, columnar_magic, sizeof(columnar_magic)) != 0) {
+        LOG_F(ERROR, "The file {} is not a valid columnar file", path);
+        size_ = 0;
+        return;
+    }
+
+    auto header = read_raw<columnar_header>(data_);
+
+    next_id_ = header.next_id;
+    rows_    = header.rows;
+    columns_ = header.columns;
+
+    // The destructor does not run when the constructor throws
+    try {
+        check(path);
+    } catch (...) {
+        release();
+        throw;
+    }
+}
+
+void budget::columnar_file::check(const std::string& path) const {
+    auto corrupted = [&path](const std::string& reason) {
+        return budget_exception("The columnar file " + path + " is corrupted: " + reason);
+    };
+
+    // Make sure that all the columns are within the file
+    if (columns_ > (size_ - sizeof(columnar_header)) / sizeof(column_entry)) {
+        throw corrupted("truncated column table");
+    }
+
+    // No column can have more rows than the file has bytes
+    if (rows_ >= size_) {
+        throw corrupted("invalid number of rows");
+    }
+
+    for (size_t c = 0; c < columns_; ++c) {
+        auto entry = read_raw<column_entry>(data_ + sizeof(columnar_header) + c * sizeof(column_entry));
+
+        if (entry.offset > size_ || entry.size > size_ - entry.offset) {
+            throw corrupted("column " + std::to_string(c) + " is truncated");
+        }
+
+        if (entry.type < static_cast<uint64_t>(data_type::BOOL) || entry.type > static_cast<uint64_t>(data_type::MONEY)) {
+            throw corrupted("column " + std::to_string(c) + " has an unknown type");
+        }
+
+        auto type = static_cast<data_type>(entry.type);
+
+        if (type != data_type::STRING) {
+            if (entry.size != rows_ * column_width(type)) {
+                throw corrupted("column " + std::to_string(c) + " has an invalid size");
+            }
+
+            continue;
+        }
+
+        // The offsets must be increasing and within the heap
+        const size_t offsets = (rows_ + 1) * 8;
+
+        if (entry.size < offsets) {
+            throw corrupted("column " + std::to_string(c) + " has an invalid size");
+        }
+
+        auto data       = data_ + entry.offset;
+        uint64_t heap   = entry.size - offsets;
+        uint64_t offset = 0;
+
+        for (size_t row = 0; row <= rows_; ++row) {
+            auto next = read_raw<uint64_t>(data + row * 8);
+
+            if (next < offset || next > heap) {
+                throw corrupted("column " + std::to_string(c) + " has an invalid string offset");
+            }
+
+            offset = next;
+        }
+    }
+}
+
+void budget::columnar_file::release() {
+#ifndef _WIN32
+    if (mapped_) {
+        ::munmap(const_cast<char*>(data_), mapped_size_);
+        mapped_ = false;
+    }
+#endif
+}
+
+budget::columnar_file::~columnar_file() {
+    release();
+}
+
+bool budget::columnar_file::valid() const {
+    return size_ > 0;
+}
+
+size_t budget::columnar_file::next_id() const {
+    return next_id_;
+}
+
+size_t budget::columnar_file::rows() const {
+    return rows_;
+}
+
+size_t budget::columnar_file::columns() const {
+    return columns_;
+}
+
+data_type budget::columnar_file::type(size_t column) const {
+    auto entry = read_raw<column_entry>(data_ + sizeof(columnar_header) + column * sizeof(column_entry));
+    return static_cast<data_type>(entry.type);
+}
+
+const char* budget::columnar_file::column_data(size_t column) const {
+    auto entry = read_raw<column_entry>(data_ + sizeof(columnar_header) + column * sizeof(column_entry));
+    return data_ + entry.offset;
+}
+
+int64_t budget::columnar_file::read_integer(size_t column, size_t row) const {
+    auto data = column_data(column);
+
+    switch (type(column)) {
+        case data_type::BOOL:
+            return read_raw<uint8_t>(data + row);
+        case data_type::INT32:
+            return read_raw<int32_t>(data + row * 4);
+        case data_type::SIZE_T:
+        case data_type::INT64:
+            return read_raw<int64_t>(data + row * 8);
+        default:
+            throw budget_exception("Column " + std::to_string(column) + " is not an integer column");
+    }
+}
+
+std::string_view budget::columnar_file::read_string(size_t column, size_t row) const {
+    if (type(column) != data_type::STRING) {
+        throw budget_exception("Column " + std::to_string(column) + " is not a string column");
+    }
+
+    auto data  = column_data(column);
+    auto start = read_raw<uint64_t>(data + row * 8);
+    auto end   = read_raw<uint64_t>(data + (row + 1) * 8);
+    auto heap  = data + (rows_ + 1) * 8;
+
+    return {heap + start, end - start};
+}
+
+budget::date budget::columnar_file::read_date(size_t column, size_t row) const {
+    if (type(column) != data_type::DATE) {
+        throw budget_exception("Column " + std::to_string(column) + " is not a date column");
+    }
+
+    auto packed = read_raw<uint32_t>(column_data(column) + row * 4);
+
+    return {static_cast<date_type>(packed >> 16), static_cast<date_type>((packed >> 8) & 0xFF), static_cast<date_type>(packed & 0xFF)};
+}
+
+budget::money budget::columnar_file::read_money(size_t column, size_t row) const {
+    if (type(column) != data_type::MONEY) {
+        throw budget_exception("Column " + std::to_string(column) + " is not a money column");
+    }
+
+    budget::money m;
+    m.value = read_raw<int64_t>(column_data(column) + row * 8);
+    return m;
+}
+
+bool budget::is_columnar_file(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+
+    char magic[sizeof(columnar_magic)];
+
+    if (!file.read(magic, sizeof(magic))) {
+        return false;
+    }
+
+    return std::memcmp(magic, columnar_magic, sizeof(columnar_magic)) == 0;
+}
+
+bool budget::write_columnar_file(const std::string& path, size_t next_id, const std::vector<data_writer>& records) {
+    std::vector<data_type> types;
+
+    if (!records.empty()) {
+        for (size_t c = 0; c < records.front().fields(); ++c) {
+            types.push_back(records.front().field_type(c));
+        }
+    }
+
+    // The columnar format needs the same schema for all the records
+    for (auto& record : records) {
+        if (record.fields() != types.size()) {
+            return false;
+        }
+
+        for (size_t c = 0; c < types.size(); ++c) {
+            if (record.field_type(c) != types[c]) {
+                return false;
+            }
+        }
+    }
+
+    const size_t rows = records.size();
+
+    std::vector<std::string> blocks(types.size());
+
+    for (size_t c = 0; c < types.size(); ++c) {
+        auto& block = blocks[c];
+
+        if (types[c] == data_type::STRING) {
+            std::string heap;
+
+            append_raw<uint64_t>(block, 0);
+
+            for (auto& record : records) {
+                heap += record.field_text(c);
+                append_raw<uint64_t>(block, heap.size());
+            }
+
+            block += heap;
+        } else {
+            block.reserve(rows * column_width(types[c]));
+
+            for (auto& record : records) {
+                auto value = record.field_value(c);
+
+                switch (types[c]) {
+                    case data_type::BOOL:
+                        append_raw<uint8_t>(block, value);
+                        break;
+                    case data_type::INT32:
+                    case data_type::DATE:
+                        append_raw<uint32_t>(block, value);
+                        break;
+                    default:
+                        append_raw<int64_t>(block, value);
+                        break;
+                }
+            }
+        }
+    }
+
+    columnar_header header;
+    std::memcpy(header.magic, columnar_magic, sizeof(columnar_magic));
+    header.next_id = next_id;
+    header.rows    = rows;
+    header.columns = types.size();
+
+    std::string out;
+    append_raw(out, header);
+
+    size_t offset = align(sizeof(columnar_header) + types.size() * sizeof(column_entry));
+
+    for (size_t c = 0; c < types.size(); ++c) {
+        column_entry entry{static_cast<uint64_t>(types[c]), offset, blocks[c].size()};
+        append_raw(out, entry);
+
+        offset = align(offset + blocks[c].size());
+    }
+
+    for (auto& block : blocks) {
+        out.resize(align(out.size()), '\0');
+        out += block;
+    }
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(out.data(), out.size());
+
+    return file.good();
+}
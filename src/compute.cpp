@@ -13,6 +13,7 @@
 #include "earnings.hpp"
 #include "accounts.hpp"
 #include "incomes.hpp"
+#include "data_cache.hpp"
 
 budget::status budget::compute_year_status(data_cache & cache) {
     auto today = budget::local_day();
@@ -26,10 +27,11 @@ budget::status budget::compute_year_status(data_cache & cache, year year) {
 budget::status budget::compute_year_status(data_cache & cache, year year, month month) {
     budget::status status;
 
-    auto sm = start_month(cache, year);
+    auto sm      = start_month(cache, year);
+    auto& totals = cache.totals();
 
-    status.expenses = accumulate_amount(all_expenses_between(cache, year, sm, month));
-    status.earnings = accumulate_amount(all_earnings_between(cache, year, sm, month));
+    status.expenses = totals.expenses_between(year, sm, month);
+    status.earnings = totals.earnings_between(year, sm, month);
 
     for (unsigned short i = sm; i <= month; ++i) {
         status.budget += accumulate_amount(all_accounts(cache, year, i));
@@ -45,7 +47,7 @@ budget::status budget::compute_year_status(data_cache & cache, year year, month
     if (has_taxes_account()) {
         auto account_id = taxes_account().id;
 
-        status.taxes = accumulate_amount(all_expenses_between(cache, account_id, year, sm, month));
+        status.taxes = totals.account_expenses_between(account_id, year, sm, month);
     }
 
     return status;
@@ -64,8 +66,8 @@ budget::status budget::compute_month_status(data_cache & cache, month month) {
 budget::status budget::compute_month_status(data_cache & cache, year year, month month) {
     budget::status status;
 
-    status.expenses    = accumulate_amount(all_expenses_month(cache, year, month));
-    status.earnings    = accumulate_amount(all_earnings_month(cache, year, month));
+    status.expenses    = cache.totals().expenses(year, month);
+    status.earnings    = cache.totals().earnings(year, month);
     status.budget      = accumulate_amount(all_accounts(cache, year, month));
     status.balance     = status.budget + status.earnings - status.expenses;
     status.base_income = get_base_income(cache, budget::date(year, month, 1));
@@ -77,7 +79,7 @@ budget::status budget::compute_month_status(data_cache & cache, year year, month
     if (has_taxes_account()) {
         auto account_id = taxes_account().id;
 
-        status.taxes = accumulate_amount(all_expenses_month(cache, account_id, year, month));
+        status.taxes = cache.totals().account_expenses(account_id, year, month);
     }
 
     return status;
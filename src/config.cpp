@@ -5,6 +5,7 @@
 //  http://opensource.org/licenses/MIT)
 //=======================================================================
 
+#include <algorithm>
 #include <iostream>
 #include <fstream>
 #include <unordered_map>
@@ -37,7 +38,7 @@ namespace {
 
 bool server_running = false;
 
-budget::server_lock internal_config_lock;
+budget::server_lock internal_config_lock("internal_config");
 
 bool load_configuration(const std::string& path, config_type& configuration){
     if (file_exists(path)) {
@@ -150,9 +151,10 @@ bool budget::load_config() {
 }
 
 void budget::save_config() {
-    if (internal != internal_bak) {
-        server_lock_guard l(internal_config_lock);
+    // The file and the backup are written, two saves must not run together
+    server_lock_guard l(internal_config_lock);
 
+    if (internal != internal_bak) {
         save_configuration(path_to_budget_file("config"), internal);
 
         internal_bak = internal;
@@ -235,6 +237,14 @@ std::string budget::config_value(const std::string& key, const std::string& def)
     return def;
 }
 
+void budget::config_set(const std::string& key, const std::string& value){
+    configuration[key] = value;
+}
+
+void budget::config_remove(const std::string& key){
+    configuration.erase(key);
+}
+
 bool budget::config_contains_and_true(const std::string& key) {
     if (config_contains(key)) {
         return config_value(key) == "true";
@@ -274,7 +284,7 @@ bool budget::user_config_value_bool(const std::string& key, bool def) {
 }
 
 bool budget::internal_config_contains(const std::string& key){
-    server_lock_guard l(internal_config_lock);
+    server_shared_lock_guard l(internal_config_lock);
     return internal.find(key) != internal.end();
 }
 
@@ -317,6 +327,10 @@ size_t budget::get_server_port(){
     return 8080;
 }
 
+size_t budget::get_fetch_concurrency(){
+    return std::max<size_t>(1, to_number<size_t>(config_value("fetch_concurrency", "8")));
+}
+
 bool budget::is_server_mode(){
     // The server cannot run in server mode
     if (is_server_running()) {
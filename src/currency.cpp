@@ -5,9 +5,20 @@
 //  http://opensource.org/licenses/MIT)
 //=======================================================================
 
-#include <tuple>
-#include <utility>
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <deque>
+#include <fstream>
 #include <iostream>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
 
 #include "currency.hpp"
 #include "assets.hpp" // For get_default_currency
@@ -16,166 +27,761 @@
 #include "config.hpp"
 #include "logging.hpp"
 #include "server_lock.hpp"
+#include "price_cache.hpp"
+#include "price_provider.hpp"
+#include "string_table.hpp"
+#include "worker_pool.hpp"
 
 namespace {
 
-struct currency_cache_key {
-    budget::date date;
+// We use a struct so that we can store values of 1 that can indicate either 
+// a valid value or an invalid one
+// Without that, we could not store values of 1 in the cache file
+struct currency_cache_value {
+    double value;
+    bool   valid;
+};
+
+struct rate_entry {
+    uint32_t day;
+    currency_cache_value value;
+};
+
+// The rates of a pair, sorted by day
+using rate_list = std::vector<rate_entry>;
+
+} // end of anonymous namespace
+
+/*!
+ * \brief The exchange rates from one currency to another.
+ *
+ * The rates are never modified in place. A new list is published
+ * atomically for each change so that readers do not need any lock.
+ * Changes must be made with exchanges_lock held.
+ */
+struct budget::currency_rates {
     std::string from;
     std::string to;
+    currency_rates* reverse = nullptr;
 
-    currency_cache_key(budget::date date, std::string from, std::string to) : date(date), from(from), to(to) {}
+    std::shared_ptr<const rate_list> snapshot() const {
+        return std::atomic_load(&rates);
+    }
 
-    friend bool operator==(const currency_cache_key & lhs, const currency_cache_key & rhs){
-        if (lhs.date != rhs.date) {
-            return false;
+    void publish(std::shared_ptr<const rate_list> values) {
+        std::atomic_store(&rates, std::move(values));
+    }
+
+    bool find(uint32_t day, currency_cache_value& value) const {
+        auto values = snapshot();
+
+        auto it = std::lower_bound(values->begin(), values->end(), day, [](auto& entry, uint32_t day) { return entry.day < day; });
+
+        if (it != values->end() && it->day == day) {
+            value = it->value;
+            return true;
         }
 
-        if (lhs.from != rhs.from) {
-            return false;
+        return false;
+    }
+
+    // Indicates if the given valid rate is already known for the day
+    bool known(uint32_t day, double rate) const {
+        currency_cache_value value;
+        return find(day, value) && value.valid && value.value == rate;
+    }
+
+    void set(uint32_t day, currency_cache_value value) {
+        auto values = std::make_shared<rate_list>(*snapshot());
+
+        auto it = std::lower_bound(values->begin(), values->end(), day, [](auto& entry, uint32_t day) { return entry.day < day; });
+
+        if (it != values->end() && it->day == day) {
+            it->value = value;
+        } else {
+            values->insert(it, {day, value});
         }
 
-        return lhs.to == rhs.to;
+        publish(std::move(values));
     }
-};
 
-// We use a struct so that we can store values of 1 that can indicate either 
-// a valid value or an invalid one
-// Without that, we could not store values of 1 in the cache file
-struct currency_cache_value {
-    double value;
-    bool   valid;
-};
+    /*!
+     * \brief Merge sorted rates into the rates of the pair, the new rates
+     * replace the existing ones of the same days
+     */
+    void merge(const rate_list& values) {
+        auto current = snapshot();
 
-} // end of anonymous namespace
+        rate_list merged;
+        merged.reserve(current->size() + values.size());
 
-namespace std {
+        auto it = current->begin();
+
+        for (auto& entry : values) {
+            while (it != current->end() && it->day < entry.day) {
+                merged.push_back(*it++);
+            }
 
-template <>
-struct hash<currency_cache_key> {
-    std::size_t operator()(const currency_cache_key & key) const noexcept {
-        auto seed = std::hash<budget::date>()(key.date);
-        seed ^= std::hash<std::string>()(key.from) + 0x9e3779b9 + (seed<<6) + (seed>>2);
-        seed ^= std::hash<std::string>()(key.to) + 0x9e3779b9 + (seed<<6) + (seed>>2);
-        return seed;
+            if (it != current->end() && it->day == entry.day) {
+                ++it;
+            }
+
+            if (!merged.empty() && merged.back().day == entry.day) {
+                merged.back() = entry;
+            } else {
+                merged.push_back(entry);
+            }
+        }
+
+        merged.insert(merged.end(), it, current->end());
+
+        publish(std::make_shared<const rate_list>(std::move(merged)));
     }
-};
 
-} // end of namespace std
+    double rate(budget::date d);
+
+    // Store a fetched rate and its reverse, exchanges_lock must be held
+    void store(budget::date d, currency_cache_value rate);
+
+private:
+    std::shared_ptr<const rate_list> rates = std::make_shared<const rate_list>();
+};
 
 namespace {
 
-// OPTIM: If necessary, this could be made faster with a two layer cache
-// We can take advantages from the low number of currency pair in the first layer
-// and then the quick hash from the high number of dates
+// The exchange rates are cached in two levels: the currency pairs, which
+// are few, and then the rates of each pair, by date
 
-std::unordered_map<currency_cache_key, currency_cache_value> exchanges;
-budget::server_lock exchanges_lock;
+budget::string_table currencies;
+std::deque<budget::currency_rates> pairs; // A deque never moves its elements
+std::unordered_map<uint64_t, budget::currency_rates*> pair_ids;
+budget::server_lock exchanges_lock("exchanges");
 
-// V2 is using api.exchangeratesapi.io
-currency_cache_value get_rate_v2(const std::string& from, const std::string& to, const std::string& date = "latest") {
-    httplib::SSLClient cli("api.exchangeratesapi.io", 443);
+// The cache file is only read when a rate is needed for the first time
+std::atomic<bool> cache_requested{false};
+std::once_flag cache_loaded;
+std::unique_ptr<budget::price_cache_file> cache_file; // Only when the file is in binary format
+
+struct pending_rate {
+    budget::currency_rates* pair;
+    uint32_t day;
+    double value;
+};
+
+// The valid rates fetched since the cache was loaded
+std::vector<pending_rate> pending;
 
-    std::string api_complete = "/" + date + "?symbols=" + to + "&base=" + from;
+// The server of the exchange rates, it can be changed while rates are
+// fetched on other threads
+std::mutex rates_server_lock;
+budget::exchange_rates_server rates_server{"api.exchangeratesapi.io", 443, true};
 
-    auto res = cli.Get(api_complete.c_str());
+budget::exchange_rates_server current_rates_server() {
+    std::lock_guard<std::mutex> l(rates_server_lock);
+    return rates_server;
+}
+
+template <typename Cli>
+std::pair<bool, std::string> base_rates_get(Cli& cli, const std::string& api, const std::string& from, const std::string& to) {
+    auto res = cli.Get(api.c_str());
 
     if (!res) {
         LOG_F(ERROR, "Currency(v2): No response, setting exchange between {} from {} to to 1/1", from, to);
-        LOG_F(ERROR, "Currency(v2): URL is {}", api_complete);
+        LOG_F(ERROR, "Currency(v2): URL is {}", api);
 
-        return {1.0, false};
+        return {false, ""};
     } else if (res->status != 200) {
         LOG_F(ERROR, "Currency(v2): Error Response {}, setting exchange between {} to {} to 1/1", res->status, from, to);
-        LOG_F(ERROR, "Currency(v2): URL is {}", api_complete);
+        LOG_F(ERROR, "Currency(v2): URL is {}", api);
         LOG_F(ERROR, "Currency(v2): Response is {}", res->body);
 
-        return {1.0, false};
+        return {false, ""};
     } else {
-        auto& buffer = res->body;
-        auto index   = "\"" + to + "\":";
+        return {true, res->body};
+    }
+}
+
+std::pair<bool, std::string> rates_get(const std::string& api, const std::string& from, const std::string& to) {
+    auto server = current_rates_server();
+
+    if (server.ssl) {
+        httplib::SSLClient cli(server.host.c_str(), server.port);
+
+        return base_rates_get(cli, api, from, to);
+    } else {
+        httplib::Client cli(server.host.c_str(), server.port);
+
+        return base_rates_get(cli, api, from, to);
+    }
+}
+
+// Parse the value following "to": at the given position of the buffer
+bool parse_rate(const std::string& buffer, const std::string& to, size_t& pos, double& value) {
+    auto index = "\"" + to + "\":";
+
+    pos = buffer.find(index, pos);
+
+    if (pos == std::string::npos) {
+        return false;
+    }
+
+    pos += index.size();
+
+    auto end = buffer.find_first_of(",}", pos);
+
+    if (end == std::string::npos) {
+        return false;
+    }
+
+    value = atof(buffer.substr(pos, end - pos).c_str());
+    pos   = end;
+
+    return true;
+}
+
+// V2 is using api.exchangeratesapi.io
+struct exchangeratesapi_provider : budget::exchange_rate_provider {
+    bool rate(const std::string& from, const std::string& to, budget::date d, double& value) override {
+        std::string api_complete = "/" + date_to_string(d) + "?symbols=" + to + "&base=" + from;
 
-        if (buffer.find(index) == std::string::npos || buffer.find('}') == std::string::npos) {
+        auto [ok, buffer] = rates_get(api_complete, from, to);
+
+        if (!ok) {
+            return false;
+        }
+
+        size_t pos = 0;
+
+        if (!parse_rate(buffer, to, pos, value)) {
             LOG_F(ERROR, "Currency(v2): Error parsing exchange rates, setting exchange between {} to {} to 1/1", from, to);
             LOG_F(ERROR, "Currency(v2): URL is {}", api_complete);
-            LOG_F(ERROR, "Currency(v2): Response is {}", res->body);
+            LOG_F(ERROR, "Currency(v2): Response is {}", buffer);
+
+            return false;
+        }
+
+        return true;
+    }
+
+    std::map<budget::date, double> rates(const std::string& from, const std::string& to, budget::date start, budget::date end) override {
+        std::string api_complete = "/history?start_at=" + date_to_string(start) + "&end_at=" + date_to_string(end) + "&symbols=" + to + "&base=" + from;
+
+        auto [ok, buffer] = rates_get(api_complete, from, to);
+
+        if (!ok) {
+            return {};
+        }
+
+        // The response looks like {"rates":{"2020-01-02":{"CHF":1.08},...},...}
+        std::map<budget::date, double> values;
+
+        size_t pos = buffer.find("\"rates\":");
+
+        if (pos != std::string::npos) {
+            pos += 7; // On the colon
+        }
+
+        while (pos != std::string::npos) {
+            auto date_start = buffer.find('"', pos + 1);
+
+            if (date_start == std::string::npos || date_start + 11 >= buffer.size() || buffer.compare(date_start + 11, 2, "\":") != 0) {
+                break;
+            }
+
+            pos = date_start + 13;
+
+            double value;
+            if (!parse_rate(buffer, to, pos, value)) {
+                break;
+            }
+
+            try {
+                values[budget::date_from_string(buffer.substr(date_start + 1, 10))] = value;
+            } catch (const budget::date_exception&) {
+                break;
+            }
+        }
+
+        if (values.empty()) {
+            LOG_F(ERROR, "Currency(v2): Error parsing exchange rates history between {} and {}", from, to);
+            LOG_F(ERROR, "Currency(v2): URL is {}", api_complete);
+            LOG_F(ERROR, "Currency(v2): Response is {}", buffer);
+        }
 
-            return {1.0, false};
+        return values;
+    }
+};
+
+std::mutex provider_lock;
+std::shared_ptr<budget::exchange_rate_provider> provider;
+
+std::shared_ptr<budget::exchange_rate_provider> get_provider() {
+    std::lock_guard<std::mutex> l(provider_lock);
+
+    if (!provider) {
+        if (budget::config_value("exchange_rate_provider", "exchangeratesapi") == "file") {
+            provider = std::make_shared<budget::file_price_provider>(budget::config_value("exchange_rate_file", budget::path_to_budget_file("exchange_rates.csv")));
         } else {
-            std::string ratio_result(buffer.begin() + buffer.find(index) + index.size(), buffer.begin() + buffer.find('}'));
+            provider = std::make_shared<exchangeratesapi_provider>();
+        }
+    }
 
-            return {atof(ratio_result.c_str()), true};
+    return provider;
+}
+
+currency_cache_value get_rate(const std::string& from, const std::string& to, budget::date d) {
+    if (double value; get_provider()->rate(from, to, d, value)) {
+        return {value, true};
+    }
+
+    return {1.0, false};
+}
+
+// Get all the rates between two dates with a single request. The days
+// without rates (week-ends and holidays) have the rate of the previous
+// day, the days before the first rate are not returned.
+rate_list get_rates(const std::string& from, const std::string& to, budget::date start, budget::date end) {
+    // Start a week earlier so that the first days have a previous rate
+    auto values = get_provider()->rates(from, to, start - budget::days(7), end);
+
+    if (values.empty()) {
+        return {};
+    }
+
+    rate_list rates;
+
+    auto it = values.begin();
+
+    for (auto day = values.begin()->first.day_number(); day <= end.day_number(); ++day) {
+        while (std::next(it) != values.end() && std::next(it)->first.day_number() <= day) {
+            ++it;
+        }
+
+        if (day >= start.day_number()) {
+            rates.push_back({day, {it->second, true}});
         }
     }
+
+    return rates;
 }
 
-} // end of anonymous namespace
+uint64_t pair_id(const std::string& from, const std::string& to) {
+    return (uint64_t(currencies.intern(from)) << 32) | currencies.intern(to);
+}
 
-void budget::load_currency_cache(){
-    std::string file_path = budget::path_to_budget_file("currency.cache");
-    std::ifstream file(file_path);
+budget::currency_rates* get_pair(const std::string& from, const std::string& to) {
+    auto id = pair_id(from, to);
 
-    if (!file.is_open() || !file.good()){
-        LOG_F(INFO, "Impossible to load Currency Cache");
-        return;
+    {
+        budget::server_shared_lock_guard l(exchanges_lock);
+
+        if (auto it = pair_ids.find(id); it != pair_ids.end()) {
+            return it->second;
+        }
     }
 
+    budget::server_lock_guard l(exchanges_lock);
+
+    if (auto it = pair_ids.find(id); it != pair_ids.end()) {
+        return it->second;
+    }
+
+    // Both directions are created together since they are updated together
+    auto& direct  = pairs.emplace_back();
+    direct.from   = from;
+    direct.to     = to;
+
+    auto& reverse = pairs.emplace_back();
+    reverse.from  = to;
+    reverse.to    = from;
+
+    direct.reverse  = &reverse;
+    reverse.reverse = &direct;
+
+    pair_ids[id]                = &direct;
+    pair_ids[pair_id(to, from)] = &reverse;
+
+    return &direct;
+}
+
+size_t cached_rates() {
+    size_t count = 0;
+
+    budget::server_shared_lock_guard l(exchanges_lock);
+
+    for (auto& pair : pairs) {
+        count += pair.snapshot()->size();
+    }
+
+    return count;
+}
+
+std::string cache_path() {
+    return budget::path_to_budget_file("currency.cache");
+}
+
+bool is_binary_format() {
+    return budget::config_value("data_format", "text") == "binary";
+}
+
+int64_t to_bits(double value) {
+    int64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+double from_bits(int64_t bits) {
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+void read_text_cache(std::ifstream& file, std::unordered_map<budget::currency_rates*, rate_list>& loaded) {
     std::string line;
     while (file.good() && getline(file, line)) {
         if (line.empty()) {
             continue;
         }
 
-        auto parts = split(line, ':');
+        auto parts = budget::split(line, ':');
 
-        currency_cache_key key(date_from_string(parts[0]), parts[1], parts[2]);
-        exchanges[key] = {budget::to_number<double>(parts[3]), true};
+        auto* pair = get_pair(parts[1], parts[2]);
+        loaded[pair].push_back({budget::date_from_string(parts[0]).day_number(), {budget::to_number<double>(parts[3]), true}});
     }
+}
+
+void read_binary_cache(const std::string& file_path, std::unordered_map<budget::currency_rates*, rate_list>& loaded) {
+    cache_file = std::make_unique<budget::price_cache_file>(file_path);
+
+    std::vector<budget::price_record> records;
+    cache_file->load(records);
+
+    // The keys are "from:to"
+    std::vector<budget::currency_rates*> key_pairs;
+
+    for (auto& record : records) {
+        if (record.key >= key_pairs.size()) {
+            key_pairs.resize(record.key + 1, nullptr);
+        }
+
+        if (!key_pairs[record.key]) {
+            auto parts = budget::split(cache_file->key(record.key), ':');
+            key_pairs[record.key] = get_pair(parts[0], parts[1]);
+        }
 
-    LOG_F(INFO, "Share Price Cache has been loaded from {}", file_path);
-    LOG_F(INFO, "Share Price Cache has {} entries", exchanges.size());
+        loaded[key_pairs[record.key]].push_back({record.day, {from_bits(record.value), true}});
+    }
 }
 
-void budget::save_currency_cache() {
-    std::string file_path = budget::path_to_budget_file("currency.cache");
-    std::ofstream file(file_path);
+void read_cache() {
+    auto file_path = cache_path();
 
-    if (!file.is_open() || !file.good()){
-        LOG_F(INFO, "Impossible to save Currency Cache");
-        return;
+    std::unordered_map<budget::currency_rates*, rate_list> loaded;
+
+    if (budget::is_price_cache_file(file_path)) {
+        read_binary_cache(file_path, loaded);
+    } else {
+        std::ifstream file(file_path);
+
+        if (!file.is_open() || !file.good()){
+            LOG_F(INFO, "Impossible to load Currency Cache");
+            return;
+        }
+
+        read_text_cache(file, loaded);
     }
 
+    // Publish the rates of each pair at once, the last rate of a date wins
+    {
+        budget::server_lock_guard l(exchanges_lock);
+
+        for (auto& [pair, values] : loaded) {
+            std::stable_sort(values.begin(), values.end(), [](auto& lhs, auto& rhs) { return lhs.day < rhs.day; });
+            pair->merge(values);
+        }
+    }
+
+    LOG_F(INFO, "Currency Cache has been loaded from {}", file_path);
+    LOG_F(INFO, "Currency Cache has {} entries", cached_rates());
+}
+
+void ensure_cache_loaded() {
+    if (cache_requested) {
+        std::call_once(cache_loaded, read_cache);
+    }
+}
+
+// Append the given rates to the current cache file
+bool append_rates(const std::string& file_path, const std::vector<pending_rate>& rates) {
+    if (is_binary_format()) {
+        std::vector<budget::price_record> records;
+
+        for (auto& [pair, day, value] : rates) {
+            records.push_back({cache_file->key_id(pair->from + ':' + pair->to), day, to_bits(value)});
+        }
+
+        return cache_file->append(records);
+    }
+
+    std::ofstream file(file_path, std::ios::app);
+
+    for (auto& [pair, day, value] : rates) {
+        file << budget::date::from_day_number(day) << ':' << pair->from << ':' << pair->to << ':' << value << std::endl;
+    }
+
+    return file.good();
+}
+
+} // end of anonymous namespace
+
+double budget::currency_rates::rate(budget::date d) {
+    auto day = d.day_number();
+
+    // Return directly if we already have the data in cache
+    if (currency_cache_value value; find(day, value)) {
+        return value.value;
+    }
+
+    // Otherwise, make the API call without the lock
+
+    auto rate = get_rate(from, to, d);
+
+    // Update the cache and the reverse cache with the lock
+
     {
         server_lock_guard l(exchanges_lock);
+        store(d, rate);
+    }
+
+    return rate.value;
+}
+
+void budget::currency_rates::store(budget::date d, currency_cache_value rate) {
+    auto day = d.day_number();
+
+    LOG_F(INFO, "Price: Currency Rate ({}) from {} to {} = {} (valid: {})", budget::to_string(d), from, to, budget::to_string(rate.value), rate.valid);
+
+    // We only write down valid values that are not already known
+    bool write = rate.valid && !known(day, rate.value);
+
+    set(day, rate);
+    reverse->set(day, {1.0 / rate.value, rate.valid});
 
-        for (auto & [key, value] : exchanges) {
-            // We only write down valid values
-            if (value.valid) {
-                file << key.date << ':' << key.from << ':' << key.to << ':' << value.value << std::endl;
+    if (write) {
+        pending.push_back({this, day, rate.value});
+        pending.push_back({reverse, day, 1.0 / rate.value});
+    }
+}
+
+void budget::load_currency_cache(){
+    cache_requested = true;
+}
+
+void budget::save_currency_cache() {
+    // Nothing to write if no rate has been fetched
+    {
+        server_shared_lock_guard l(exchanges_lock);
+
+        if (pending.empty()) {
+            return;
+        }
+    }
+
+    auto file_path = cache_path();
+
+    // The current content of the file must be known before writing to it,
+    // even if the cache has never been used
+    std::call_once(cache_loaded, read_cache);
+
+    // The file is written under the lock, two saves must not write it at
+    // the same time
+    server_lock_guard l(exchanges_lock);
+
+    auto rates = std::move(pending);
+    pending.clear();
+
+    if (rates.empty()) {
+        return;
+    }
+
+    // If the file is not in the current format, it is rewritten with all the rates
+    if (is_binary_format() != bool(cache_file)) {
+        if (is_binary_format()) {
+            cache_file = std::make_unique<price_cache_file>(file_path);
+        } else {
+            cache_file.reset();
+            std::ofstream file(file_path, std::ios::trunc);
+        }
+
+        std::vector<pending_rate> all;
+
+        for (auto & pair : pairs) {
+            for (auto & [day, value] : *pair.snapshot()) {
+                if (value.valid) {
+                    all.push_back({&pair, day, value.value});
+                }
             }
         }
+
+        // The new rates are written last so that they win over the old ones
+        all.insert(all.end(), rates.begin(), rates.end());
+        rates = std::move(all);
     }
 
-    LOG_F(INFO, "Share Price Cache has been loaded to {}", file_path);
-    LOG_F(INFO, "Share Price Cache has {} entries", exchanges.size());
+    if (!append_rates(file_path, rates)) {
+        LOG_F(INFO, "Impossible to save Currency Cache");
+        return;
+    }
+
+    LOG_F(INFO, "Currency Cache has been saved to {}", file_path);
+    LOG_F(INFO, "Currency Cache has {} new entries", rates.size());
 }
 
 void budget::refresh_currency_cache(){
-    std::unordered_map<currency_cache_key, currency_cache_value> copy;
+    ensure_cache_loaded();
+
+    std::vector<budget::currency_rates*> copy;
 
     {
-        server_lock_guard l(exchanges_lock);
+        server_shared_lock_guard l(exchanges_lock);
 
-        copy = exchanges;
+        for (auto & pair : pairs) {
+            if (!pair.snapshot()->empty()) {
+                copy.push_back(&pair);
+            }
+        }
     }
 
-    // Refresh/Prefetch the current exchange rates
-    for (auto & [key, value] : copy) {
-        exchange_rate(key.from, key.to);
+    // Refresh/Prefetch the current exchange rates, the reverse of a pair
+    // is updated together with it
+    std::vector<budget::currency_rates*> missing;
+    std::unordered_set<budget::currency_rates*> selected;
+
+    auto today = budget::local_day();
+
+    for (auto* pair : copy) {
+        if (currency_cache_value value; pair->find(today.day_number(), value)) {
+            continue;
+        }
+
+        if (!selected.count(pair->reverse)) {
+            selected.insert(pair);
+            missing.push_back(pair);
+        }
+    }
+
+    std::vector<currency_cache_value> rates(missing.size());
+
+    parallel_for(missing.size(), get_fetch_concurrency(), [&](size_t i) {
+        rates[i] = get_rate(missing[i]->from, missing[i]->to, today);
+    });
+
+    if (!missing.empty()) {
+        server_lock_guard l(exchanges_lock);
+
+        for (size_t i = 0; i < missing.size(); ++i) {
+            missing[i]->store(today, rates[i]);
+        }
     }
 
     LOG_F(INFO, "Currency Cache has been refreshed");
-    LOG_F(INFO, "Currency Cache has {} entries", exchanges.size());
+    LOG_F(INFO, "Currency Cache has {} entries", cached_rates());
+}
+
+void budget::prefetch_exchange_rates(const std::vector<std::pair<currency_pair, budget::date>>& rates){
+    ensure_cache_loaded();
+
+    struct fetch_span {
+        budget::currency_rates* pair;
+        budget::date start;
+        budget::date end;
+    };
+
+    std::vector<fetch_span> spans;
+    std::unordered_map<budget::currency_rates*, size_t> span_index;
+
+    auto today = budget::local_day();
+
+    for (auto& [handle, d] : rates) {
+        auto* pair = handle.rates;
+
+        if (!pair) {
+            continue;
+        }
+
+        auto date = std::min(d, today);
+
+        if (currency_cache_value value; pair->find(date.day_number(), value)) {
+            continue;
+        }
+
+        // A pair and its reverse are fetched together
+        if (span_index.count(pair->reverse)) {
+            pair = pair->reverse;
+        }
+
+        if (auto it = span_index.find(pair); it != span_index.end()) {
+            auto& span = spans[it->second];
+            span.start = std::min(span.start, date);
+            span.end   = std::max(span.end, date);
+        } else {
+            span_index[pair] = spans.size();
+            spans.push_back({pair, date, date});
+        }
+    }
+
+    if (spans.empty()) {
+        return;
+    }
+
+    std::vector<rate_list> fetched(spans.size());
+
+    parallel_for(spans.size(), get_fetch_concurrency(), [&](size_t i) {
+        fetched[i] = get_rates(spans[i].pair->from, spans[i].pair->to, spans[i].start, spans[i].end);
+    });
+
+    server_lock_guard l(exchanges_lock);
+
+    for (size_t i = 0; i < spans.size(); ++i) {
+        auto* pair = spans[i].pair;
+
+        // The missing dates will be fetched one by one
+        if (fetched[i].empty()) {
+            continue;
+        }
+
+        rate_list reverse;
+        reverse.reserve(fetched[i].size());
+
+        for (auto& [day, value] : fetched[i]) {
+            reverse.push_back({day, {1.0 / value.value, true}});
+
+            // Only the new rates need to be written to the cache file
+            if (!pair->known(day, value.value)) {
+                pending.push_back({pair, day, value.value});
+                pending.push_back({pair->reverse, day, 1.0 / value.value});
+            }
+        }
+
+        pair->merge(fetched[i]);
+        pair->reverse->merge(reverse);
+
+        LOG_F(INFO, "Price: Currency Rates ({}-{}) from {} to {}: {} rates", budget::to_string(spans[i].start), budget::to_string(spans[i].end), pair->from, pair->to, fetched[i].size());
+    }
+}
+
+void budget::set_exchange_rate_provider(std::shared_ptr<exchange_rate_provider> new_provider){
+    std::lock_guard<std::mutex> l(provider_lock);
+    provider = std::move(new_provider);
+}
+
+void budget::set_exchange_rates_server(const std::string& host, size_t port, bool ssl){
+    std::lock_guard<std::mutex> l(rates_server_lock);
+    rates_server = {host, port, ssl};
+}
+
+budget::exchange_rates_server budget::get_exchange_rates_server(){
+    return current_rates_server();
 }
 
 double budget::exchange_rate(const std::string& from){
@@ -198,34 +804,44 @@ double budget::exchange_rate(const std::string& from, const std::string& to, bud
     } else if (d > budget::local_day()) {
         return exchange_rate(from, to, budget::local_day());
     } else {
-        currency_cache_key key(d, from, to);
+        ensure_cache_loaded();
+        return get_pair(from, to)->rate(d);
+    }
+}
 
-        // Return directly if we already have the data in cache
-        {
-            server_lock_guard l(exchanges_lock);
+budget::currency_pair budget::get_currency_pair(const std::string& from, const std::string& to) {
+    if (from == to) {
+        return currency_pair(nullptr);
+    }
 
-            if (exchanges.find(key) != exchanges.end()) {
-                return exchanges[key].value;
-            }
-        }
+    ensure_cache_loaded();
+    return currency_pair(get_pair(from, to));
+}
 
-        // Otherwise, make the API call without the lock
+double budget::currency_pair::rate(budget::date d) const {
+    if (!rates) {
+        return 1.0;
+    }
 
-        auto rate = get_rate_v2(from, to, date_to_string(d));
+    return rates->rate(std::min(d, budget::local_day()));
+}
 
-        LOG_F(INFO, "Price: Currency Rate ({}) from {} to {} = {} (valid: {})", budget::to_string(d), from, to, budget::to_string(rate.value), rate.valid);
+double budget::currency_pair::previous_rate(budget::date d) const {
+    if (!rates) {
+        return 1.0;
+    }
 
-        // Update the cache and the reverse cache with the lock
+    auto values = rates->snapshot();
 
-        currency_cache_key reverse_key(d, to, from);
+    auto it = std::upper_bound(values->begin(), values->end(), d.day_number(), [](uint32_t day, auto& entry) { return day < entry.day; });
 
-        {
-            server_lock_guard l(exchanges_lock);
+    while (it != values->begin()) {
+        --it;
 
-            exchanges[key]         = rate;
-            exchanges[reverse_key] = {1.0 / rate.value, rate.valid};
+        if (it->value.valid) {
+            return it->value.value;
         }
-
-        return rate.value;
     }
+
+    return rate(d);
 }
@@ -6,22 +6,42 @@
 //=======================================================================
 
 #include <charconv>
+#include <filesystem>
+#include <fstream>
 
 #include "data.hpp"
 #include "utils.hpp"
 #include "date.hpp"
 #include "money.hpp"
+#include "logging.hpp"
+
+namespace fs = std::filesystem;
 
 namespace {
 
-void parse_input(std::vector<std::string>& parts) {
-    for (auto& part : parts) {
-        size_t start_pos = 0;
-        while ((start_pos = part.find("\\x3A", start_pos)) != std::string::npos) {
-            part.replace(start_pos, 4, ":");
-            ++start_pos;
+// Decode the escaped ':' of the given field in place and return the
+// decoded field. The decoded field is never longer than the input.
+std::string_view decode_field(char* first, char* last) {
+    std::string_view field(first, last - first);
+
+    auto pos = field.find("\\x3A");
+
+    if (pos == std::string_view::npos) {
+        return field;
+    }
+
+    char* out = first + pos;
+
+    for (char* in = first + pos; in != last;) {
+        if (last - in >= 4 && std::string_view(in, 4) == "\\x3A") {
+            *out++ = ':';
+            in += 4;
+        } else {
+            *out++ = *in++;
         }
     }
+
+    return {first, static_cast<size_t>(out - first)};
 }
 
 std::string parse_output(const std::vector<std::string>& parts) {
@@ -46,29 +66,119 @@ std::string parse_output(const std::vector<std::string>& parts) {
 // Note: This function is necessary because writing numbers used to be
 // locale-dependent. To read older database, we need to handle , in numbers
 // and spaces as practical utility
-std::string pre_clean_number(std::string str) {
+std::string pre_clean_number(std::string_view view) {
+    std::string str(view);
     str.erase(std::remove(str.begin(), str.end(), ','), str.end());
     str.erase(std::remove(str.begin(), str.end(), ' '), str.end());
     return str;
 }
 
+// Parse an integer directly from the view, only cleaning it when necessary
+template <typename T>
+bool parse_integer(std::string_view view, T& value) {
+    if (view.find_first_of(", ") != std::string_view::npos) {
+        auto part = pre_clean_number(view);
+        return parse_integer(std::string_view(part), value);
+    }
+
+    auto [p, ec] = std::from_chars(view.data(), view.data() + view.size(), value);
+    return ec == std::errc() && p == view.data() + view.size();
+}
+
+// The persisters of all the data handlers. The registry is never
+// destroyed since the handlers may be destroyed after it otherwise.
+struct persister_registry {
+    std::mutex lock;
+    std::vector<budget::persister*> persisters;
+};
+
+persister_registry& registry() {
+    static auto* registry = new persister_registry();
+    return *registry;
+}
+
 } // namespace
 
 // data_reader
 
-void budget::data_reader::parse(const std::string& data) {
-    parts   = split(data, ':');
+void budget::data_reader::parse(std::string_view data) {
+    line.assign(data.data(), data.size());
+    parts.clear();
     current = 0;
+    columns = nullptr;
 
-    parse_input(parts);
+    // Same semantics as split(): a trailing empty field is ignored
+    char* first = line.data();
+    char* last  = line.data() + line.size();
+
+    while (first != last) {
+        char* sep = std::find(first, last, ':');
+
+        parts.push_back(decode_field(first, sep));
+
+        if (sep == last) {
+            break;
+        }
+
+        first = sep + 1;
+
+        if (first == last) {
+            break;
+        }
+    }
+}
+
+void budget::data_reader::parse(const columnar_file& file, size_t row) {
+    parts.clear();
+    current   = 0;
+    columns   = &file;
+    this->row = row;
+}
+
+std::string_view budget::data_reader::view() const {
+    return parts.at(current);
+}
+
+std::string budget::data_reader::part() const {
+    if (!columns) {
+        return std::string(parts.at(current));
+    }
+
+    if (current >= columns->columns()) {
+        throw budget::budget_exception("No more fields in the columnar record");
+    }
+
+    switch (columns->type(current)) {
+        case data_type::STRING:
+            return std::string(columns->read_string(current, row));
+        case data_type::DATE:
+            return budget::date_to_string(columns->read_date(current, row));
+        case data_type::MONEY:
+            return budget::to_string(columns->read_money(current, row));
+        default:
+            return std::to_string(columns->read_integer(current, row));
+    }
+}
+
+bool budget::data_reader::integer_column() const {
+    if (!columns || current >= columns->columns()) {
+        return false;
+    }
+
+    auto type = columns->type(current);
+    return type == data_type::BOOL || type == data_type::SIZE_T || type == data_type::INT64 || type == data_type::INT32;
 }
 
 budget::data_reader& budget::data_reader::operator>>(bool& value) {
-    auto part = pre_clean_number(parts.at(current));
+    if (integer_column()) {
+        value = columns->read_integer(current, row);
+        ++current;
+        return *this;
+    }
 
     size_t temp;
-    if (auto [p, ec] = std::from_chars(part.data(), part.data() + part.size(), temp); ec != std::errc() || p != part.data() + part.size()) {
-        throw budget::budget_exception("\"" + parts.at(current) + "\" is not a valid bool");
+    if (columns ? !parse_integer(std::string_view(part()), temp) : !parse_integer(view(), temp)) {
+        throw budget::budget_exception("\"" + part() + "\" is not a valid bool");
     }
 
     value = temp;
@@ -78,10 +188,14 @@ budget::data_reader& budget::data_reader::operator>>(bool& value) {
 }
 
 budget::data_reader& budget::data_reader::operator>>(size_t& value) {
-    auto part = pre_clean_number(parts.at(current));
+    if (integer_column()) {
+        value = columns->read_integer(current, row);
+        ++current;
+        return *this;
+    }
 
-    if (auto [p, ec] = std::from_chars(part.data(), part.data() + part.size(), value); ec != std::errc() || p != part.data() + part.size()) {
-        throw budget::budget_exception("\"" + parts.at(current) + "\" is not a valid size_t");
+    if (columns ? !parse_integer(std::string_view(part()), value) : !parse_integer(view(), value)) {
+        throw budget::budget_exception("\"" + part() + "\" is not a valid size_t");
     }
 
     ++current;
@@ -89,10 +203,14 @@ budget::data_reader& budget::data_reader::operator>>(size_t& value) {
 }
 
 budget::data_reader& budget::data_reader::operator>>(int64_t& value) {
-    auto part = pre_clean_number(parts.at(current));
+    if (integer_column()) {
+        value = columns->read_integer(current, row);
+        ++current;
+        return *this;
+    }
 
-    if (auto [p, ec] = std::from_chars(part.data(), part.data() + part.size(), value); ec != std::errc() || p != part.data() + part.size()) {
-        throw budget::budget_exception("\"" + parts.at(current) + "\" is not a valid int64_t");
+    if (columns ? !parse_integer(std::string_view(part()), value) : !parse_integer(view(), value)) {
+        throw budget::budget_exception("\"" + part() + "\" is not a valid int64_t");
     }
 
     ++current;
@@ -100,10 +218,14 @@ budget::data_reader& budget::data_reader::operator>>(int64_t& value) {
 }
 
 budget::data_reader& budget::data_reader::operator>>(int32_t& value) {
-    auto part = pre_clean_number(parts.at(current));
+    if (integer_column()) {
+        value = columns->read_integer(current, row);
+        ++current;
+        return *this;
+    }
 
-    if (auto [p, ec] = std::from_chars(part.data(), part.data() + part.size(), value); ec != std::errc() || p != part.data() + part.size()) {
-        throw budget::budget_exception("\"" + parts.at(current) + "\" is not a valid int32_t");
+    if (columns ? !parse_integer(std::string_view(part()), value) : !parse_integer(view(), value)) {
+        throw budget::budget_exception("\"" + part() + "\" is not a valid int32_t");
     }
 
     ++current;
@@ -111,7 +233,7 @@ budget::data_reader& budget::data_reader::operator>>(int32_t& value) {
 }
 
 budget::data_reader& budget::data_reader::operator>>(double& value) {
-    auto part = pre_clean_number(parts.at(current));
+    auto part = pre_clean_number(this->part());
 
     // Note: Unfortunately, gcc is not c++17 complete for the library
     // since from_chars double is not implemented, we need to use the old
@@ -122,7 +244,7 @@ budget::data_reader& budget::data_reader::operator>>(double& value) {
     value = std::strtod(start, &end);
 
     if (end != start + part.size()) {
-        throw budget::budget_exception("\"" + parts.at(current) + "\" is not a valid double");
+        throw budget::budget_exception("\"" + this->part() + "\" is not a valid double");
     }
 
     ++current;
@@ -130,29 +252,45 @@ budget::data_reader& budget::data_reader::operator>>(double& value) {
 }
 
 budget::data_reader& budget::data_reader::operator>>(std::string& value) {
-    value = parts.at(current);
+    value = part();
     ++current;
     return *this;
 }
 
 budget::data_reader& budget::data_reader::operator>>(budget::date& value) {
-    value = budget::date_from_string(parts.at(current));
+    if (columns && current < columns->columns() && columns->type(current) == data_type::DATE) {
+        value = columns->read_date(current, row);
+        ++current;
+        return *this;
+    }
+
+    value = columns ? budget::date_from_string(part()) : budget::date_from_string(view());
     ++current;
     return *this;
 }
 
 budget::data_reader& budget::data_reader::operator>>(budget::money& value) {
-    value = budget::money_from_string(parts.at(current));
+    if (columns && current < columns->columns() && columns->type(current) == data_type::MONEY) {
+        value = columns->read_money(current, row);
+        ++current;
+        return *this;
+    }
+
+    value = columns ? budget::money_from_string(part()) : budget::money_from_string(view());
     ++current;
     return *this;
 }
 
 bool budget::data_reader::more() const {
+    if (columns) {
+        return current < columns->columns();
+    }
+
     return current < parts.size();
 }
 
 std::string budget::data_reader::peek() const {
-    return parts.at(current);
+    return part();
 }
 
 void budget::data_reader::skip() {
@@ -170,6 +308,8 @@ budget::data_writer& budget::data_writer::operator<<(const bool& value){
 
     if (auto [p, ec] = std::to_chars(buffer.begin(), buffer.end(), temp); ec == std::errc()) {
         parts.emplace_back(buffer.begin(), p);
+        types.push_back(data_type::BOOL);
+        values.push_back(temp);
         return *this;
     } else {
         throw budget::budget_exception("\"" + std::to_string(temp) + "\" cant' be converted to string");
@@ -181,6 +321,8 @@ budget::data_writer& budget::data_writer::operator<<(const size_t& value){
 
     if (auto [p, ec] = std::to_chars(buffer.begin(), buffer.end(), value); ec == std::errc()) {
         parts.emplace_back(buffer.begin(), p);
+        types.push_back(data_type::SIZE_T);
+        values.push_back(static_cast<int64_t>(value));
         return *this;
     } else {
         throw budget::budget_exception("\"" + std::to_string(value) + "\" cant' be converted to string");
@@ -192,6 +334,8 @@ budget::data_writer& budget::data_writer::operator<<(const int64_t& value){
 
     if (auto [p, ec] = std::to_chars(buffer.begin(), buffer.end(), value); ec == std::errc()) {
         parts.emplace_back(buffer.begin(), p);
+        types.push_back(data_type::INT64);
+        values.push_back(static_cast<int64_t>(value));
         return *this;
     } else {
         throw budget::budget_exception("\"" + std::to_string(value) + "\" cant' be converted to string");
@@ -203,6 +347,8 @@ budget::data_writer& budget::data_writer::operator<<(const int32_t& value){
 
     if (auto [p, ec] = std::to_chars(buffer.begin(), buffer.end(), value); ec == std::errc()) {
         parts.emplace_back(buffer.begin(), p);
+        types.push_back(data_type::INT32);
+        values.push_back(static_cast<int64_t>(value));
         return *this;
     } else {
         throw budget::budget_exception("\"" + std::to_string(value) + "\" cant' be converted to string");
@@ -211,19 +357,220 @@ budget::data_writer& budget::data_writer::operator<<(const int32_t& value){
 
 budget::data_writer& budget::data_writer::operator<<(const std::string& value){
     parts.emplace_back(value);
+    types.push_back(data_type::STRING);
+    values.push_back(0);
     return *this;
 }
 
 budget::data_writer& budget::data_writer::operator<<(const budget::date& value){
     parts.emplace_back(budget::date_to_string(value));
+    types.push_back(data_type::DATE);
+    values.push_back((int64_t(value.year()) << 16) | (int64_t(value.month()) << 8) | int64_t(value.day()));
     return *this;
 }
 
 budget::data_writer& budget::data_writer::operator<<(const budget::money& value){
     parts.emplace_back(budget::to_string(value));
+    types.push_back(data_type::MONEY);
+    values.push_back(value.value);
     return *this;
 }
 
 std::string budget::data_writer::to_string() const {
     return parse_output(parts);
 }
+
+size_t budget::data_writer::fields() const {
+    return parts.size();
+}
+
+budget::data_type budget::data_writer::field_type(size_t i) const {
+    return types.at(i);
+}
+
+int64_t budget::data_writer::field_value(size_t i) const {
+    return values.at(i);
+}
+
+const std::string& budget::data_writer::field_text(size_t i) const {
+    return parts.at(i);
+}
+
+// persistence
+
+std::string budget::journal_path(const std::string& file_path) {
+    return file_path + ".journal";
+}
+
+bool budget::write_data_batch(const std::string& file_path, const data_batch& batch, bool columnar, const char* module) {
+    if (!batch.rewrite) {
+        if (!batch.journal.empty()) {
+            std::ofstream file(journal_path(file_path), std::ios::app);
+
+            for (auto& line : batch.journal) {
+                file << line << '\n';
+            }
+
+            file.close();
+
+            if (!file) {
+                LOG_F(ERROR, "Unable to append to {}", journal_path(file_path));
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    auto temp_path = file_path + ".tmp";
+
+    bool written = false;
+
+    if (columnar) {
+        written = write_columnar_file(temp_path, batch.next_id, batch.records);
+
+        if (!written) {
+            LOG_F(WARNING, "Unable to save {} in columnar format, falling back to text", module);
+        }
+    }
+
+    if (!written) {
+        std::ofstream file(temp_path, std::ios::trunc);
+
+        // We still save the file ID so that it's still compatible with older versions for now
+        file << batch.next_id << '\n';
+
+        for (auto& record : batch.records) {
+            file << record.to_string() << '\n';
+        }
+
+        file.close();
+
+        if (!file) {
+            LOG_F(ERROR, "Unable to write {}", temp_path);
+            return false;
+        }
+    }
+
+    std::error_code ec;
+    fs::rename(temp_path, file_path, ec);
+
+    if (ec) {
+        LOG_F(ERROR, "Unable to replace {}: {}", file_path, ec.message());
+        return false;
+    }
+
+    // The data file contains everything, the journal can be dropped
+    std::remove(journal_path(file_path).c_str());
+
+    return true;
+}
+
+budget::persister::persister(std::function<void()> flush) : flush(std::move(flush)) {
+    delay       = std::chrono::milliseconds(to_number<size_t>(config_value("persist_delay", "50")));
+    max_latency = std::chrono::milliseconds(to_number<size_t>(config_value("persist_max_latency", "1000")));
+
+    {
+        std::lock_guard<std::mutex> l(registry().lock);
+        registry().persisters.push_back(this);
+    }
+
+    thread = std::thread([this]() { run(); });
+}
+
+budget::persister::~persister() {
+    stop();
+
+    auto& persisters = registry().persisters;
+
+    std::lock_guard<std::mutex> l(registry().lock);
+    persisters.erase(std::remove(persisters.begin(), persisters.end(), this), persisters.end());
+}
+
+void budget::persister::notify() {
+    {
+        std::lock_guard<std::mutex> l(mutex);
+
+        auto now = std::chrono::steady_clock::now();
+
+        if (!dirty) {
+            dirty        = true;
+            first_change = now;
+        }
+
+        last_change = now;
+
+        // The thread may have been stopped by stop_persistence()
+        if (stopping && !running) {
+            if (thread.joinable()) {
+                thread.join();
+            }
+
+            stopping = false;
+            running  = true;
+            thread   = std::thread([this]() { run(); });
+        }
+    }
+
+    cv.notify_one();
+}
+
+void budget::persister::stop() {
+    std::thread stopped;
+
+    // The thread is taken under the lock since notify() may restart it
+    {
+        std::lock_guard<std::mutex> l(mutex);
+        stopping = true;
+        stopped  = std::move(thread);
+    }
+
+    cv.notify_one();
+
+    if (stopped.joinable()) {
+        stopped.join();
+    }
+}
+
+void budget::persister::run() {
+    std::unique_lock<std::mutex> l(mutex);
+
+    while (true) {
+        cv.wait(l, [this]() { return dirty || stopping; });
+
+        if (!dirty) {
+            running = false;
+            return;
+        }
+
+        // Wait for the changes to settle down, but not for too long
+        while (!stopping) {
+            auto deadline = std::min(last_change + delay, first_change + max_latency);
+
+            if (std::chrono::steady_clock::now() >= deadline) {
+                break;
+            }
+
+            cv.wait_until(l, deadline);
+        }
+
+        dirty = false;
+
+        l.unlock();
+        flush();
+        l.lock();
+    }
+}
+
+void budget::stop_persistence() {
+    std::vector<persister*> current;
+
+    {
+        std::lock_guard<std::mutex> l(registry().lock);
+        current = registry().persisters;
+    }
+
+    for (auto* persister : current) {
+        persister->stop();
+    }
+}
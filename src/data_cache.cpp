@@ -5,191 +5,323 @@
 //  http://opensource.org/licenses/MIT)
 //=======================================================================
 
+#include <algorithm>
+#include <array>
+#include <mutex>
+
 #include "data_cache.hpp"
 
 using namespace budget;
 
-std::vector<earning> & data_cache::earnings() {
-    if (earnings_.empty()) {
+namespace {
+
+/*!
+ * \brief A view derived from the data of a module, shared by all the caches.
+ *
+ * The view is rebuilt only when it is requested for another generation of
+ * the data than the one it was built from. Views derived from several
+ * modules use the generations of all of them.
+ */
+template <typename V, typename Generation = size_t>
+struct shared_view {
+    template <typename Builder>
+    std::shared_ptr<const V> get(Generation generation, Builder builder) {
+        std::lock_guard<std::mutex> l(lock);
+
+        if (!view || view_generation != generation) {
+            view            = std::make_shared<const V>(builder());
+            view_generation = generation;
+        }
+
+        return view;
+    }
+
+private:
+    std::mutex lock;
+    std::shared_ptr<const V> view;
+    Generation view_generation{};
+};
+
+shared_view<month_index<earning>> earnings_index_view;
+shared_view<transactions> earning_transactions_view;
+shared_view<std::vector<asset_value>> sorted_asset_values_view;
+shared_view<std::unordered_map<size_t, std::vector<asset_value>>> sorted_group_asset_values_view;
+shared_view<std::unordered_map<size_t, std::vector<asset_value>>> sorted_group_liabilities_view;
+shared_view<month_index<expense>> expenses_index_view;
+shared_view<transactions> expense_transactions_view;
+shared_view<std::vector<asset>> user_assets_view;
+shared_view<account_index> accounts_index_view;
+shared_view<share_positions> asset_share_positions_view;
+shared_view<month_totals, std::array<size_t, 3>> month_totals_view;
+shared_view<net_worth_series, std::array<size_t, 4>> net_worth_view;
+
+} // end of anonymous namespace
+
+const std::vector<earning> & data_cache::earnings() {
+    // A snapshot always has a generation, only the default one has none
+    if (!earnings_.generation()) {
         earnings_ = all_earnings();
     }
 
-    return earnings_;
+    return earnings_.get();
 }
 
-std::vector<earning> & data_cache::sorted_earnings() {
-    if (sorted_earnings_.empty()) {
-        sorted_earnings_ = all_earnings();
+const std::vector<earning> & data_cache::sorted_earnings() {
+    return earnings_index().sorted();
+}
 
-        std::sort(sorted_earnings_.begin(), sorted_earnings_.end(), [](auto& lhs, auto& rhs) {
-            return lhs.date < rhs.date;
-        });
+const month_index<earning> & data_cache::earnings_index() {
+    if (!earnings_index_) {
+        auto& values    = earnings();
+        earnings_index_ = earnings_index_view.get(earnings_.generation(), [&values]() { return month_index<earning>(values); });
+    }
+
+    return *earnings_index_;
+}
+
+const transactions & data_cache::earning_transactions() {
+    if (!earning_transactions_) {
+        auto& values          = earnings_index().sorted();
+        earning_transactions_ = earning_transactions_view.get(earnings_.generation(), [&values]() { return transactions(values); });
+    }
+
+    return *earning_transactions_;
+}
+
+const month_totals & data_cache::totals() {
+    if (!totals_) {
+        auto& e = expense_transactions();
+        auto& r = earning_transactions();
+        auto& a = accounts();
+
+        std::array<size_t, 3> generation{expenses_.generation(), earnings_.generation(), accounts_.generation()};
+
+        totals_ = month_totals_view.get(generation, [&e, &r, &a]() { return month_totals(e, r, a); });
+    }
+
+    return *totals_;
+}
+
+const net_worth_series & data_cache::net_worth() {
+    if (!net_worth_) {
+        auto& a = assets();
+        auto& l = liabilities();
+        auto& v = sorted_asset_values();
+        auto& s = asset_share_positions();
+
+        std::array<size_t, 4> generation{assets_.generation(), liabilities_.generation(), asset_values_.generation(), asset_shares_.generation()};
+
+        net_worth_ = net_worth_view.get(generation, [&a, &l, &v, &s]() { return net_worth_series(a, l, v, s); });
     }
 
-    return sorted_earnings_;
+    return *net_worth_;
 }
 
-std::vector<debt> & data_cache::debts() {
-    if (debts_.empty()) {
+const std::vector<debt> & data_cache::debts() {
+    if (!debts_.generation()) {
         debts_ = all_debts();
     }
 
-    return debts_;
+    return debts_.get();
 }
 
-std::vector<fortune> & data_cache::fortunes() {
-    if (fortunes_.empty()) {
+const std::vector<fortune> & data_cache::fortunes() {
+    if (!fortunes_.generation()) {
         fortunes_ = all_fortunes();
     }
 
-    return fortunes_;
+    return fortunes_.get();
 }
 
-std::vector<asset_value> & data_cache::asset_values() {
-    if (asset_values_.empty()) {
+const std::vector<asset_value> & data_cache::asset_values() {
+    if (!asset_values_.generation()) {
         asset_values_ = all_asset_values();
     }
 
-    return asset_values_;
+    return asset_values_.get();
 }
 
-std::vector<asset_value> & data_cache::sorted_asset_values() {
-    if (sorted_asset_values_.empty()) {
-        sorted_asset_values_ = all_asset_values();
+const std::vector<asset_value> & data_cache::sorted_asset_values() {
+    if (!sorted_asset_values_) {
+        auto& values         = asset_values();
+        sorted_asset_values_ = sorted_asset_values_view.get(asset_values_.generation(), [&values]() {
+            std::vector<asset_value> sorted = values;
 
-        std::stable_sort(sorted_asset_values_.begin(), sorted_asset_values_.end(), [](auto& lhs, auto& rhs) {
-            return lhs.set_date < rhs.set_date;
+            std::stable_sort(sorted.begin(), sorted.end(), [](auto& lhs, auto& rhs) {
+                return lhs.set_date < rhs.set_date;
+            });
+
+            return sorted;
         });
     }
 
-    return sorted_asset_values_;
+    return *sorted_asset_values_;
 }
 
-std::unordered_map<size_t, std::vector<asset_value>> & data_cache::sorted_group_asset_values(bool liability) {
-    if (liability) {
-        if (sorted_group_asset_values_liabilities_.empty()) {
-            for (auto& asset_value : sorted_asset_values()) {
-                if (asset_value.liability) {
-                    sorted_group_asset_values_liabilities_[asset_value.asset_id].push_back(asset_value);
-                }
-            }
-        }
+const std::vector<asset_value> & data_cache::sorted_group_asset_values(size_t asset_id, bool liability) {
+    static const std::vector<asset_value> no_values;
+
+    auto& groups = liability ? sorted_group_asset_values_liabilities_ : sorted_group_asset_values_;
 
-        return sorted_group_asset_values_liabilities_;
-    } else {
-        if (sorted_group_asset_values_.empty()) {
-            for (auto& asset_value : sorted_asset_values()) {
-                if (!asset_value.liability) {
-                    sorted_group_asset_values_[asset_value.asset_id].push_back(asset_value);
+    if (!groups) {
+        auto& values = sorted_asset_values();
+        auto& view   = liability ? sorted_group_liabilities_view : sorted_group_asset_values_view;
+
+        groups = view.get(asset_values_.generation(), [&values, liability]() {
+            asset_value_groups groups;
+
+            for (auto& asset_value : values) {
+                if (asset_value.liability == liability) {
+                    groups[asset_value.asset_id].push_back(asset_value);
                 }
             }
-        }
 
-        return sorted_group_asset_values_;
+            return groups;
+        });
     }
+
+    if (auto it = groups->find(asset_id); it != groups->end()) {
+        return it->second;
+    }
+
+    return no_values;
 }
 
-std::vector<liability> & data_cache::liabilities() {
-    if (liabilities_.empty()) {
+const std::vector<liability> & data_cache::liabilities() {
+    if (!liabilities_.generation()) {
         liabilities_ = all_liabilities();
     }
 
-    return liabilities_;
+    return liabilities_.get();
 }
 
-std::vector<recurring> & data_cache::recurrings() {
-    if (recurrings_.empty()) {
+const std::vector<recurring> & data_cache::recurrings() {
+    if (!recurrings_.generation()) {
         recurrings_ = all_recurrings();
     }
 
-    return recurrings_;
+    return recurrings_.get();
 }
 
-std::vector<income> & data_cache::incomes() {
-    if (incomes_.empty()) {
+const std::vector<income> & data_cache::incomes() {
+    if (!incomes_.generation()) {
         incomes_ = all_incomes();
     }
 
-    return incomes_;
+    return incomes_.get();
 }
 
-std::vector<account> & data_cache::accounts() {
-    if (accounts_.empty()) {
+const std::vector<account> & data_cache::accounts() {
+    if (!accounts_.generation()) {
         accounts_ = all_accounts();
     }
 
-    return accounts_;
+    return accounts_.get();
 }
 
-std::vector<asset_share> & data_cache::asset_shares() {
-    if (asset_shares_.empty()) {
+const account_index & data_cache::accounts_index() {
+    if (!accounts_index_) {
+        auto& values    = accounts();
+        accounts_index_ = accounts_index_view.get(accounts_.generation(), [&values]() { return account_index(values); });
+    }
+
+    return *accounts_index_;
+}
+
+const std::vector<asset_share> & data_cache::asset_shares() {
+    if (!asset_shares_.generation()) {
         asset_shares_ = all_asset_shares();
     }
 
-    return asset_shares_;
+    return asset_shares_.get();
 }
 
-std::vector<asset_class> & data_cache::asset_classes() {
-    if (asset_classes_.empty()) {
+const share_positions & data_cache::asset_share_positions() {
+    if (!asset_share_positions_) {
+        auto& values           = asset_shares();
+        asset_share_positions_ = asset_share_positions_view.get(asset_shares_.generation(), [&values]() { return share_positions(values); });
+    }
+
+    return *asset_share_positions_;
+}
+
+const std::vector<asset_class> & data_cache::asset_classes() {
+    if (!asset_classes_.generation()) {
         asset_classes_ = all_asset_classes();
     }
 
-    return asset_classes_;
+    return asset_classes_.get();
 }
 
-std::vector<objective> & data_cache::objectives() {
-    if (objectives_.empty()) {
+const std::vector<objective> & data_cache::objectives() {
+    if (!objectives_.generation()) {
         objectives_ = all_objectives();
     }
 
-    return objectives_;
+    return objectives_.get();
 }
 
-std::vector<expense> & data_cache::expenses() {
-    if (expenses_.empty()) {
+const std::vector<expense> & data_cache::expenses() {
+    if (!expenses_.generation()) {
         expenses_ = all_expenses();
     }
 
-    return expenses_;
+    return expenses_.get();
 }
 
-std::vector<expense> & data_cache::sorted_expenses() {
-    if (sorted_expenses_.empty()) {
-        sorted_expenses_ = all_expenses();
+const std::vector<expense> & data_cache::sorted_expenses() {
+    return expenses_index().sorted();
+}
 
-        std::sort(sorted_expenses_.begin(), sorted_expenses_.end(), [](auto& lhs, auto& rhs) {
-            return lhs.date < rhs.date;
-        });
+const month_index<expense> & data_cache::expenses_index() {
+    if (!expenses_index_) {
+        auto& values    = expenses();
+        expenses_index_ = expenses_index_view.get(expenses_.generation(), [&values]() { return month_index<expense>(values); });
+    }
+
+    return *expenses_index_;
+}
+
+const transactions & data_cache::expense_transactions() {
+    if (!expense_transactions_) {
+        auto& values          = expenses_index().sorted();
+        expense_transactions_ = expense_transactions_view.get(expenses_.generation(), [&values]() { return transactions(values); });
     }
 
-    return sorted_expenses_;
+    return *expense_transactions_;
 }
 
-std::vector<asset> & data_cache::assets() {
-    if (assets_.empty()) {
+const std::vector<asset> & data_cache::assets() {
+    if (!assets_.generation()) {
         assets_ = all_assets();
     }
 
-    return assets_;
+    return assets_.get();
 }
 
-std::vector<asset> & data_cache::user_assets() {
-    if (user_assets_.empty()) {
-        for (auto & asset : assets()) {
-            if (asset.name != "DESIRED") {
-                user_assets_.push_back(asset);
+const std::vector<asset> & data_cache::user_assets() {
+    if (!user_assets_) {
+        auto& values = assets();
+        user_assets_ = user_assets_view.get(assets_.generation(), [&values]() {
+            std::vector<asset> user_assets;
+
+            for (auto & asset : values) {
+                if (asset.name != "DESIRED") {
+                    user_assets.push_back(asset);
+                }
             }
-        }
+
+            return user_assets;
+        });
     }
 
-    return user_assets_;
+    return *user_assets_;
 }
 
-std::vector<wish> & data_cache::wishes() {
-    if (wishes_.empty()) {
+const std::vector<wish> & data_cache::wishes() {
+    if (!wishes_.generation()) {
         wishes_ = all_wishes();
     }
 
-    return wishes_;
+    return wishes_.get();
 }
-
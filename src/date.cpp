@@ -76,38 +76,16 @@ std::string budget::date_to_string(budget::date date){
 }
 
 unsigned short budget::start_month(data_cache & cache, budget::year year){
-    budget::month m = 12;
-
-    for (auto& expense : cache.expenses()) {
-        if (expense.date.year() == year) {
-            m = std::min(expense.date.month(), m);
-        }
-    }
-
-    for (auto& earning : cache.earnings()) {
-        if (earning.date.year() == year) {
-            m = std::min(earning.date.month(), m);
-        }
-    }
-
-    return m;
+    return cache.totals().start_month(year);
 }
 
 unsigned short budget::start_year(data_cache & cache){
     auto today = budget::local_day();
     auto y = today.year();
 
-    for (auto& expense : cache.expenses()) {
-        if (expense.date != TEMPLATE_DATE) {
-            y = std::min(expense.date.year(), y);
-        }
-    }
-
-    for (auto& earning : cache.earnings()) {
-        if (earning.date != TEMPLATE_DATE) {
-            y = std::min(earning.date.year(), y);
-        }
-    }
+    // The transactions are sorted, only the first real one is necessary
+    y = std::min(cache.expense_transactions().first_date(TEMPLATE_DATE, today).year(), y);
+    y = std::min(cache.earning_transactions().first_date(TEMPLATE_DATE, today).year(), y);
 
     return y;
 }
@@ -66,10 +66,6 @@ std::map<std::string, std::string> budget::debt::get_params() const {
     return params;
 }
 
-void budget::debt_module::load(){
-    load_debts();
-}
-
 void budget::debt_module::unload(){
     save_debts();
 }
@@ -101,7 +97,7 @@ void budget::debt_module::handle(const std::vector<std::string>& args){
 
             size_t id = to_number<size_t>(args[2]);
 
-            auto debt = debts[id];
+            budget::debt debt = debts[id];
             debt.state = 1;
 
             if (debts.indirect_edit(debt)) {
@@ -122,7 +118,7 @@ void budget::debt_module::handle(const std::vector<std::string>& args){
 
             size_t id = to_number<size_t>(args[2]);
 
-            auto debt = debts[id];
+            budget::debt debt = debts[id];
             edit(debt);
 
             if (debts.indirect_edit(debt)) {
@@ -168,7 +164,7 @@ void budget::debt::load(data_reader & reader){
     }
 }
 
-std::vector<debt> budget::all_debts(){
+data_snapshot<debt> budget::all_debts(){
     return debts.data();
 }
 
@@ -26,6 +26,10 @@ namespace {
 
 static data_handler<earning> earnings { "earnings", "earnings.data" };
 
+filter_view<earning> make_range_view(const month_index<earning>::range& range) {
+    return filter_view<earning>(range.first, range.second);
+}
+
 } //end of anonymous namespace
 
 std::map<std::string, std::string> budget::earning::get_params() const {
@@ -41,11 +45,6 @@ std::map<std::string, std::string> budget::earning::get_params() const {
     return params;
 }
 
-void budget::earnings_module::load(){
-    load_earnings();
-    load_accounts();
-}
-
 void budget::earnings_module::unload(){
     save_earnings();
 }
@@ -105,11 +104,11 @@ void budget::earnings_module::handle(const std::vector<std::string>& args){
 
             size_t id = to_number<size_t>(args[2]);
 
-            auto earning = earnings[id];
+            budget::earning earning = earnings[id];
 
             edit_date(earning.date, "Date");
 
-            auto account_name = get_account(earning.account).name;
+            auto account_name = get_account(earning.account)->name;
             edit_string_complete(account_name, "Account", all_account_names(), not_empty_checker(), account_checker(earning.date));
             earning.account = get_account(account_name, earning.date.year(), earning.date.month()).id;
 
@@ -155,7 +154,7 @@ void budget::earning::load(data_reader & reader){
     }
 }
 
-std::vector<earning> budget::all_earnings(){
+data_snapshot<earning> budget::all_earnings(){
     return earnings.data();
 }
 
@@ -182,7 +181,7 @@ void budget::show_all_earnings(budget::writer& w){
     std::vector<std::vector<std::string>> contents;
 
     for(auto& earning : earnings.data()){
-        contents.push_back({to_string(earning.id), to_string(earning.date), get_account(earning.account).name, earning.name, to_string(earning.amount)});
+        contents.push_back({to_string(earning.id), to_string(earning.date), get_account(earning.account)->name, earning.name, to_string(earning.amount)});
     }
 
     w.display_table(columns, contents);
@@ -205,7 +204,7 @@ void budget::search_earnings(const std::string& search, budget::writer& w){
         std::transform(l_name.begin(), l_name.end(), l_name.begin(), ::tolower);
 
         if(l_name.find(l_search) != std::string::npos){
-            contents.push_back({to_string(earning.id), to_string(earning.date), get_account(earning.account).name, earning.name, to_string(earning.amount), "::edit::earnings::" + to_string(earning.id)});
+            contents.push_back({to_string(earning.id), to_string(earning.date), get_account(earning.account)->name, earning.name, to_string(earning.amount), "::edit::earnings::" + to_string(earning.id)});
 
             total += earning.amount;
             ++count;
@@ -234,7 +233,7 @@ void budget::show_earnings(budget::month month, budget::year year, budget::write
 
     for(auto& earning : earnings.data()){
         if(earning.date.year() == year && earning.date.month() == month){
-            contents.push_back({to_string(earning.id), to_string(earning.date), get_account(earning.account).name, earning.name, to_string(earning.amount), "::edit::earnings::" + to_string(earning.id)});
+            contents.push_back({to_string(earning.id), to_string(earning.date), get_account(earning.account)->name, earning.name, to_string(earning.amount), "::edit::earnings::" + to_string(earning.id)});
 
             total += earning.amount;
             ++count;
@@ -279,25 +278,17 @@ earning budget::earning_get(size_t id) {
 }
 
 filter_view<earning> budget::all_earnings_year(data_cache & cache, budget::year year) {
-    return make_filter_view(cache.earnings(), [=](const earning& e) {
-        return e.date.year() == year;
-    });
+    return make_range_view(cache.earnings_index().year(year));
 }
 
 filter_view<earning> budget::all_earnings_month(data_cache & cache, budget::year year, budget::month month) {
-    return make_filter_view(cache.earnings(), [=](const earning& e) {
-        return e.date.year() == year && e.date.month() == month;
-    });
+    return make_range_view(cache.earnings_index().month(year, month));
 }
 
 filter_view<earning> budget::all_earnings_month(data_cache & cache, size_t account_id, budget::year year, budget::month month) {
-    return make_filter_view(cache.earnings(), [=](const earning& e) {
-        return e.account == account_id && e.date.year() == year && e.date.month() == month;
-    });
+    return make_range_view(cache.earnings_index().month(account_id, year, month));
 }
 
 filter_view<earning> budget::all_earnings_between(data_cache & cache, budget::year year, budget::month sm, budget::month month) {
-    return make_filter_view(cache.earnings(), [=](const earning& e) {
-        return e.date.year() == year && e.date.month() >= sm && e.date.month() <= month;
-    });
+    return make_range_view(cache.earnings_index().between(year, sm, month));
 }
@@ -34,7 +34,7 @@ void show_templates() {
 
     for (auto& expense : expenses.data()) {
         if (expense.date == TEMPLATE_DATE) {
-            contents.push_back({to_string(expense.id), get_account(expense.account).name, expense.name, to_string(expense.amount)});
+            contents.push_back({to_string(expense.id), get_account(expense.account)->name, expense.name, to_string(expense.amount)});
             ++count;
         }
     }
@@ -47,6 +47,10 @@ void show_templates() {
     }
 }
 
+filter_view<expense> make_range_view(const month_index<expense>::range& range) {
+    return filter_view<expense>(range.first, range.second);
+}
+
 } //end of anonymous namespace
 
 std::map<std::string, std::string> budget::expense::get_params() const {
@@ -62,11 +66,6 @@ std::map<std::string, std::string> budget::expense::get_params() const {
     return params;
 }
 
-void budget::expenses_module::load(){
-    load_expenses();
-    load_accounts();
-}
-
 void budget::expenses_module::unload(){
     save_expenses();
 }
@@ -178,11 +177,11 @@ void budget::expenses_module::handle(const std::vector<std::string>& args){
 
             size_t id = to_number<size_t>(args[2]);
 
-            auto expense = expenses[id];
+            budget::expense expense = expenses[id];
 
             edit_date(expense.date, "Date");
 
-            auto account_name = get_account(expense.account).name;
+            auto account_name = get_account(expense.account)->name;
             edit_string_complete(account_name, "Account", all_account_names(), not_empty_checker(), account_checker(expense.date));
             expense.account = get_account(account_name, expense.date.year(), expense.date.month()).id;
 
@@ -241,7 +240,7 @@ void budget::expense::load(data_reader & reader){
     }
 }
 
-std::vector<expense> budget::all_expenses(){
+data_snapshot<expense> budget::all_expenses(){
     return expenses.data();
 }
 
@@ -262,7 +261,7 @@ void budget::show_all_expenses(budget::writer& w){
     for (auto& expense : expenses.data()) {
         contents.push_back({to_string(expense.id),
                             to_string(expense.date),
-                            get_account(expense.account).name,
+                            get_account(expense.account)->name,
                             expense.name,
                             to_string(expense.amount),
                             "::edit::expenses::" + to_string(expense.id)});
@@ -290,7 +289,7 @@ void budget::search_expenses(const std::string& search, budget::writer& w){
         if (l_name.find(l_search) != std::string::npos) {
             contents.push_back({to_string(expense.id),
                                 to_string(expense.date),
-                                get_account(expense.account).name,
+                                get_account(expense.account)->name,
                                 expense.name,
                                 to_string(expense.amount),
                                 "::edit::expenses::" + to_string(expense.id)});
@@ -324,7 +323,7 @@ void budget::show_expenses(budget::month month, budget::year year, budget::write
         if (expense.date.year() == year && expense.date.month() == month) {
             contents.push_back({to_string(expense.id),
                                 to_string(expense.date),
-                                get_account(expense.account).name,
+                                get_account(expense.account)->name,
                                 expense.name,
                                 to_string(expense.amount),
                                 "::edit::expenses::" + to_string(expense.id)});
@@ -372,31 +371,21 @@ expense budget::expense_get(size_t id) {
 }
 
 filter_view<expense> budget::all_expenses_year(data_cache & cache, budget::year year) {
-    return make_filter_view(cache.expenses(), [=](const expense& e) {
-        return e.date.year() == year;
-    });
+    return make_range_view(cache.expenses_index().year(year));
 }
 
 filter_view<expense> budget::all_expenses_month(data_cache & cache, budget::year year, budget::month month) {
-    return make_filter_view(cache.expenses(), [=](const expense& e) {
-        return e.date.year() == year && e.date.month() == month;
-    });
+    return make_range_view(cache.expenses_index().month(year, month));
 }
 
 filter_view<expense> budget::all_expenses_month(data_cache & cache, size_t account_id, budget::year year, budget::month month) {
-    return make_filter_view(cache.expenses(), [=](const expense& e) {
-        return e.account == account_id && e.date.year() == year && e.date.month() == month;
-    });
+    return make_range_view(cache.expenses_index().month(account_id, year, month));
 }
 
 filter_view<expense> budget::all_expenses_between(data_cache & cache, budget::year year, budget::month sm, budget::month month) {
-    return make_filter_view(cache.expenses(), [=](const expense& e) {
-        return e.date.year() == year && e.date.month() >= sm && e.date.month() <= month;
-    });
+    return make_range_view(cache.expenses_index().between(year, sm, month));
 }
 
 filter_view<expense> budget::all_expenses_between(data_cache & cache, size_t account_id, budget::year year, budget::month sm, budget::month month) {
-    return make_filter_view(cache.expenses(), [=](const expense& e) {
-        return e.account == account_id && e.date.year() == year && e.date.month() >= sm && e.date.month() <= month;
-    });
+    return make_range_view(cache.expenses_index().between(account_id, year, sm, month));
 }
@@ -66,7 +66,7 @@ void budget::status_fortunes(budget::writer& w, bool short_view){
     auto columns = short_view ? short_columns : long_columns;
     std::vector<std::vector<std::string>> contents;
 
-    auto sorted_values = fortunes.data();
+    std::vector<budget::fortune> sorted_values = fortunes.data();
 
     std::sort(sorted_values.begin(), sorted_values.end(),
         [](const budget::fortune& a, const budget::fortune& b){ return a.check_date < b.check_date; });
@@ -156,10 +156,6 @@ budget::money budget::current_fortune(){
     return fortune_amount;
 }
 
-void budget::fortune_module::load(){
-    load_fortunes();
-}
-
 void budget::fortune_module::unload(){
     save_fortunes();
 }
@@ -208,7 +204,7 @@ void budget::fortune_module::handle(const std::vector<std::string>& args){
 
             size_t id = to_number<size_t>(args[2]);
 
-            auto fortune = fortunes[id];
+            budget::fortune fortune = fortunes[id];
 
             edit_date(fortune.check_date, "Date");
 
@@ -223,7 +219,7 @@ void budget::fortune_module::handle(const std::vector<std::string>& args){
     }
 }
 
-std::vector<fortune> budget::all_fortunes(){
+data_snapshot<fortune> budget::all_fortunes(){
     return fortunes.data();
 }
 
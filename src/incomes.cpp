@@ -40,10 +40,6 @@ std::map<std::string, std::string> budget::income::get_params() const {
     return params;
 }
 
-void budget::incomes_module::load(){
-    load_incomes();
-}
-
 void budget::incomes_module::unload(){
     save_incomes();
 }
@@ -118,7 +114,7 @@ void budget::income::load(data_reader& reader) {
     }
 }
 
-std::vector<income> budget::all_incomes(){
+data_snapshot<income> budget::all_incomes(){
     return incomes.data();
 }
 
@@ -192,7 +188,7 @@ budget::income budget::new_income(budget::money amount, bool print){
     new_income.amount = amount;
 
     if (incomes.size()) {
-        auto incomes_copy = all_incomes();
+        std::vector<budget::income> incomes_copy = all_incomes();
 
         // Try to edit the income from the same month
         for (auto & income : incomes_copy) {
@@ -221,7 +217,7 @@ budget::income budget::new_income(budget::money amount, bool print){
             }
         }
 
-        auto previous_income = incomes[id];
+        budget::income previous_income = incomes[id];
 
         previous_income.until = since - budget::days(1);
 
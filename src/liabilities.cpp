@@ -29,7 +29,7 @@ using namespace budget;
 
 namespace {
 
-static data_handler<liability> liabilities { "liabilities", "liabilities.data" };
+static data_handler<liability> liabilities { "liabilities", "liabilities.data", {{"name", [](const liability& l) { return l.name; }}} };
 
 std::vector<std::string> get_liabilities_names(){
     std::vector<std::string> names;
@@ -54,11 +54,6 @@ std::map<std::string, std::string> budget::liability::get_params() const {
     return params;
 }
 
-void budget::liabilities_module::load(){
-    load_liabilities();
-    load_asset_values();
-}
-
 void budget::liabilities_module::unload(){
     save_liabilities();
     save_asset_values();
@@ -130,7 +125,7 @@ void budget::liabilities_module::handle(const std::vector<std::string>& args){
                 id = get_liability(name).id;
             }
 
-            auto liability = liabilities[id];
+            budget::liability liability = liabilities[id];
 
             edit_string(liability.name, "Name", not_empty_checker());
 
@@ -188,7 +183,7 @@ void budget::liabilities_module::handle(const std::vector<std::string>& args){
                         throw budget_exception("Cannot edit asset value from the liability module");
                     }
 
-                    std::string liability_name = get_liability(value.asset_id).name;
+                    std::string liability_name = get_liability(value.asset_id)->name;
                     edit_string_complete(liability_name, "Asset", get_liabilities_names(), not_empty_checker(), liability_checker());
                     value.asset_id = get_liability(liability_name).id;
 
@@ -232,15 +227,13 @@ void budget::save_liabilities(){
     liabilities.save();
 }
 
-budget::liability budget::get_liability(size_t id){
+budget::data_entry<budget::liability> budget::get_liability(size_t id){
     return liabilities[id];
 }
 
 budget::liability budget::get_liability(std::string name){
-    for(auto& liability : liabilities.data()){
-        if(liability.name == name){
-            return liability;
-        }
+    if (auto matches = liabilities.find("name", name); !matches.empty()) {
+        return matches.front();
     }
 
     cpp_unreachable("The liability does not exist");
@@ -269,16 +262,10 @@ void budget::liability::load(data_reader & reader){
 }
 
 bool budget::liability_exists(const std::string& name){
-    for (auto& liability : all_liabilities()) {
-        if (liability.name == name) {
-            return true;
-        }
-    }
-
-    return false;
+    return liabilities.contains("name", name);
 }
 
-std::vector<liability> budget::all_liabilities(){
+data_snapshot<liability> budget::all_liabilities(){
     return liabilities.data();
 }
 
@@ -373,31 +360,19 @@ bool budget::no_liabilities() {
     return liabilities.empty();
 }
 
-budget::money budget::get_liability_value(budget::liability & liability, budget::date d, data_cache & cache) {
-    budget::money asset_value_amount;
-
-    for (auto& asset_value : cache.sorted_group_asset_values(true)[liability.id]) {
-        if (asset_value.set_date <= d) {
-            if (asset_value.liability) {
-                asset_value_amount = asset_value.amount;
-            }
-        } else {
-            break;
-        }
-    }
-
-    return asset_value_amount;
+budget::money budget::get_liability_value(const budget::liability & liability, budget::date d, data_cache & cache) {
+    return cache.net_worth().liability_value(liability, d);
 }
 
-budget::money budget::get_liability_value(budget::liability & liability, data_cache & cache) {
+budget::money budget::get_liability_value(const budget::liability & liability, data_cache & cache) {
     return get_liability_value(liability, budget::local_day(), cache);
 }
 
-budget::money budget::get_liability_value_conv(budget::liability & liability, data_cache & cache) {
+budget::money budget::get_liability_value_conv(const budget::liability & liability, data_cache & cache) {
     return get_liability_value_conv(liability, budget::local_day(), cache);
 }
 
-budget::money budget::get_liability_value_conv(budget::liability & liability, budget::date d, data_cache & cache) {
+budget::money budget::get_liability_value_conv(const budget::liability & liability, budget::date d, data_cache & cache) {
     auto amount = get_liability_value(liability, d, cache);
 
     if (amount) {
@@ -407,11 +382,11 @@ budget::money budget::get_liability_value_conv(budget::liability & liability, bu
     }
 }
 
-budget::money budget::get_liability_value_conv(budget::liability & liability, const std::string& currency, data_cache & cache) {
+budget::money budget::get_liability_value_conv(const budget::liability & liability, const std::string& currency, data_cache & cache) {
     return get_liability_value_conv(liability, budget::local_day(), currency, cache);
 }
 
-budget::money budget::get_liability_value_conv(budget::liability & liability, budget::date d, const std::string& currency, data_cache & cache) {
+budget::money budget::get_liability_value_conv(const budget::liability & liability, budget::date d, const std::string& currency, data_cache & cache) {
     auto amount = get_liability_value(liability, d, cache);
 
     if (amount) {
@@ -0,0 +1,104 @@
+//=======================================================================
+// Copyright (c) 2013-2020 Baptiste Wicht.
+// Distributed under the terms of the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+#include <future>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "loader.hpp"
+#include "budget_exception.hpp"
+#include "config.hpp"
+
+#include "accounts.hpp"
+#include "assets.hpp"
+#include "debts.hpp"
+#include "earnings.hpp"
+#include "expenses.hpp"
+#include "fortune.hpp"
+#include "incomes.hpp"
+#include "liabilities.hpp"
+#include "objectives.hpp"
+#include "recurring.hpp"
+#include "wishes.hpp"
+
+using namespace budget;
+
+namespace {
+
+using loader_function = void (*)();
+
+const std::unordered_map<std::string, loader_function>& loaders() {
+    static const std::unordered_map<std::string, loader_function> loaders{
+        {"accounts", load_accounts},
+        {"asset_classes", load_asset_classes},
+        {"asset_shares", load_asset_shares},
+        {"asset_values", load_asset_values},
+        {"assets", load_assets},
+        {"debts", load_debts},
+        {"earnings", load_earnings},
+        {"expenses", load_expenses},
+        {"fortunes", load_fortunes},
+        {"incomes", load_incomes},
+        {"liabilities", load_liabilities},
+        {"objectives", load_objectives},
+        {"recurrings", load_recurrings},
+        {"wishes", load_wishes}};
+
+    return loaders;
+}
+
+} // end of anonymous namespace
+
+void budget::load_concurrently(const std::vector<const char*>& modules) {
+    std::unordered_set<std::string> names(modules.begin(), modules.end());
+
+    // load_assets() already loads these ones
+    if (names.count("assets")) {
+        names.erase("asset_classes");
+        names.erase("asset_shares");
+        names.erase("asset_values");
+    }
+
+    for (auto& name : names) {
+        if (!loaders().count(name)) {
+            throw budget_exception("There is no module named " + name + " to load");
+        }
+    }
+
+    // Random mode uses a global generator that cannot be shared
+    if (config_contains("random")) {
+        for (auto& name : names) {
+            loaders().at(name)();
+        }
+
+        return;
+    }
+
+    std::vector<std::future<void>> futures;
+
+    for (auto& name : names) {
+        futures.push_back(std::async(std::launch::async, loaders().at(name)));
+    }
+
+    // Wait for all the modules before propagating the first error
+    std::exception_ptr error;
+
+    for (auto& future : futures) {
+        try {
+            future.get();
+        } catch (...) {
+            if (!error) {
+                error = std::current_exception();
+            }
+        }
+    }
+
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
@@ -15,23 +15,29 @@
 
 using namespace budget;
 
-money budget::money_from_string(std::string money_string){
+money budget::money_from_string(std::string_view money_string){
     // In order to read locale-dependent data (legacy), we need
     // to allow , in the numbers
     // TODO In the future, we can remove this code
-    money_string.erase(std::remove(money_string.begin(), money_string.end(), ','), money_string.end());
+    if (money_string.find(',') != std::string_view::npos) {
+        std::string cleaned(money_string);
+        cleaned.erase(std::remove(cleaned.begin(), cleaned.end(), ','), cleaned.end());
+        return money_from_string(std::string_view(cleaned));
+    }
 
     int dollars = 0;
     int cents = 0;
 
-    if (auto [p, ec] = std::from_chars(money_string.data(), money_string.data() + money_string.size(), dollars); ec == std::errc()) {
-        if (p == money_string.data() + money_string.size()) {
+    const char* end = money_string.data() + money_string.size();
+
+    if (auto [p, ec] = std::from_chars(money_string.data(), end, dollars); ec == std::errc()) {
+        if (p == end) {
             return {dollars, cents};
         } else if(*p == '.') {
             ++p;
 
-            if (auto [p2, ec] = std::from_chars(p, money_string.data() + money_string.size(), cents); ec == std::errc()) {
-                if (p2 == money_string.data() + money_string.size()) {
+            if (auto [p2, ec] = std::from_chars(p, end, cents); ec == std::errc()) {
+                if (p2 == end) {
                     if (cents >= 0 && cents < 100) {
                         return {dollars, cents};
                     }
@@ -40,7 +46,7 @@ money budget::money_from_string(std::string money_string){
         }
     }
 
-    throw budget::budget_exception("\"" + money_string + "\" is not a valid amount of money");
+    throw budget::budget_exception("\"" + std::string(money_string) + "\" is not a valid amount of money");
 }
 
 std::string budget::money_to_string(const money& amount) {
@@ -0,0 +1,228 @@
+//=======================================================================
+// Copyright (c) 2013-2020 Baptiste Wicht.
+// Distributed under the terms of the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+#include <algorithm>
+#include <limits>
+
+#include "month_totals.hpp"
+#include "transactions.hpp"
+#include "aggregation.hpp"
+#include "expenses.hpp"
+#include "accounts.hpp"
+
+using namespace budget;
+
+namespace {
+
+// The templates are not real expenses, they are dated before anything else
+void update_years(const transactions& values, size_t& first, size_t& last) {
+    const auto template_day = TEMPLATE_DATE.day_number();
+
+    for (auto day : values.days) {
+        if (day != template_day) {
+            first = std::min<size_t>(first, budget::date::from_day_number(day).year());
+            break;
+        }
+    }
+
+    if (!values.empty() && values.days.back() != template_day) {
+        last = std::max<size_t>(last, budget::date::from_day_number(values.days.back()).year());
+    }
+}
+
+} //end of anonymous namespace
+
+budget::month_totals::month_totals(const transactions& expenses, const transactions& earnings, const std::vector<account>& accounts) {
+    size_t first = std::numeric_limits<size_t>::max();
+    size_t last  = 0;
+
+    update_years(expenses, first, last);
+    update_years(earnings, first, last);
+
+    if (first <= last) {
+        first_year = first;
+        years      = last - first + 1;
+    }
+
+    std::unordered_map<size_t, std::string> account_names;
+
+    for (auto& account : accounts) {
+        account_names[account.id] = account.name;
+    }
+
+    all[EXPENSES].resize(years * 12);
+    all[EARNINGS].resize(years * 12);
+
+    add(expenses, EXPENSES, account_names);
+    add(earnings, EARNINGS, account_names);
+
+    // The first month of each year with an expense or an earning
+    for (size_t y = first_year; y < first_year + years; ++y) {
+        auto start = budget::date(y, 1, 1).day_number();
+        auto end   = budget::date(y + 1, 1, 1).day_number();
+
+        for (auto* values : {&expenses, &earnings}) {
+            auto it = std::lower_bound(values->days.begin(), values->days.end(), start);
+
+            if (it != values->days.end() && *it < end) {
+                auto month = budget::date::from_day_number(*it).month();
+
+                if (auto current = start_months.find(y); current == start_months.end() || month < current->second) {
+                    start_months.insert_or_assign(y, month);
+                }
+            }
+        }
+    }
+}
+
+void budget::month_totals::add(const transactions& values, size_t kind, const std::unordered_map<size_t, std::string>& account_names) {
+    const size_t months = years * 12;
+
+    if (!months) {
+        return;
+    }
+
+    std::vector<uint32_t> month_starts;
+    month_starts.reserve(months + 1);
+
+    for (size_t y = first_year; y < first_year + years; ++y) {
+        for (size_t m = 1; m <= 12; ++m) {
+            month_starts.push_back(budget::date(y, m, 1).day_number());
+        }
+    }
+
+    month_starts.push_back(budget::date(first_year + years, 1, 1).day_number());
+
+    // Give a dense row to each account
+    std::vector<uint32_t> account_rows;
+    std::vector<size_t> row_accounts;
+
+    for (auto account : values.accounts) {
+        if (account >= account_rows.size()) {
+            account_rows.resize(account + 1, any_account);
+        }
+
+        if (account_rows[account] == any_account) {
+            account_rows[account] = row_accounts.size();
+            row_accounts.push_back(account);
+        }
+    }
+
+    std::vector<int64_t> buckets(row_accounts.size() * months, 0);
+
+    histogram(values.days.data(), values.accounts.data(), values.amounts.data(), values.size(), month_starts, account_rows, buckets.data());
+
+    for (size_t r = 0; r < row_accounts.size(); ++r) {
+        auto account = row_accounts[r];
+
+        auto& id_row = ids[account];
+        id_row[EXPENSES].resize(months);
+        id_row[EARNINGS].resize(months);
+
+        row* name_row = nullptr;
+
+        if (auto it = account_names.find(account); it != account_names.end()) {
+            name_row = &names[it->second];
+            (*name_row)[EXPENSES].resize(months);
+            (*name_row)[EARNINGS].resize(months);
+        }
+
+        for (size_t slot = 0; slot < months; ++slot) {
+            budget::money amount;
+            amount.value = buckets[r * months + slot];
+
+            id_row[kind][slot] += amount;
+            all[kind][slot] += amount;
+
+            if (name_row) {
+                (*name_row)[kind][slot] += amount;
+            }
+        }
+    }
+}
+
+budget::money budget::month_totals::sum(const row* r, size_t kind, size_t year, size_t sm, size_t month) const {
+    budget::money total;
+
+    month = std::min<size_t>(month, 12);
+
+    if (!r || year < first_year || year >= first_year + years || sm < 1) {
+        return total;
+    }
+
+    auto& totals = (*r)[kind];
+
+    for (size_t m = sm; m <= month; ++m) {
+        total += totals[(year - first_year) * 12 + (m - 1)];
+    }
+
+    return total;
+}
+
+const budget::month_totals::row* budget::month_totals::find_row(size_t account) const {
+    if (auto it = ids.find(account); it != ids.end()) {
+        return &it->second;
+    }
+
+    return nullptr;
+}
+
+const budget::month_totals::row* budget::month_totals::find_row(const std::string& account) const {
+    if (auto it = names.find(account); it != names.end()) {
+        return &it->second;
+    }
+
+    return nullptr;
+}
+
+budget::money budget::month_totals::expenses(budget::year year, budget::month month) const {
+    return sum(&all, EXPENSES, year, month, month);
+}
+
+budget::money budget::month_totals::expenses_between(budget::year year, budget::month sm, budget::month month) const {
+    return sum(&all, EXPENSES, year, sm, month);
+}
+
+budget::money budget::month_totals::account_expenses(size_t account, budget::year year, budget::month month) const {
+    return sum(find_row(account), EXPENSES, year, month, month);
+}
+
+budget::money budget::month_totals::account_expenses_between(size_t account, budget::year year, budget::month sm, budget::month month) const {
+    return sum(find_row(account), EXPENSES, year, sm, month);
+}
+
+budget::money budget::month_totals::account_expenses(const std::string& account, budget::year year, budget::month month) const {
+    return sum(find_row(account), EXPENSES, year, month, month);
+}
+
+budget::money budget::month_totals::earnings(budget::year year, budget::month month) const {
+    return sum(&all, EARNINGS, year, month, month);
+}
+
+budget::money budget::month_totals::earnings_between(budget::year year, budget::month sm, budget::month month) const {
+    return sum(&all, EARNINGS, year, sm, month);
+}
+
+budget::money budget::month_totals::account_earnings(size_t account, budget::year year, budget::month month) const {
+    return sum(find_row(account), EARNINGS, year, month, month);
+}
+
+budget::money budget::month_totals::account_earnings_between(size_t account, budget::year year, budget::month sm, budget::month month) const {
+    return sum(find_row(account), EARNINGS, year, sm, month);
+}
+
+budget::money budget::month_totals::account_earnings(const std::string& account, budget::year year, budget::month month) const {
+    return sum(find_row(account), EARNINGS, year, month, month);
+}
+
+budget::month budget::month_totals::start_month(budget::year year) const {
+    if (auto it = start_months.find(year); it != start_months.end()) {
+        return it->second;
+    }
+
+    return 12;
+}
@@ -0,0 +1,195 @@
+//=======================================================================
+// Copyright (c) 2013-2020 Baptiste Wicht.
+// Distributed under the terms of the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+#include <algorithm>
+
+#include "net_worth.hpp"
+#include "share.hpp"
+
+using namespace budget;
+
+namespace {
+
+struct position_change {
+    uint32_t day;
+    size_t row;
+    int64_t amount;
+};
+
+} //end of anonymous namespace
+
+budget::net_worth_series::net_worth_series(const std::vector<asset>& assets, const std::vector<liability>& liabilities,
+                                           const std::vector<budget::asset_value>& sorted_asset_values, const budget::share_positions& share_positions) {
+    auto currency = get_default_currency();
+
+    for (auto& asset : assets) {
+        asset_rows[asset.id] = rows.size();
+        rows.push_back({asset.id, false, asset.name != "DESIRED", asset.share_based, asset.ticker, get_currency_pair(asset.currency, currency)});
+    }
+
+    for (auto& liability : liabilities) {
+        liability_rows[liability.id] = rows.size();
+        rows.push_back({liability.id, true, true, false, "", get_currency_pair(liability.currency, currency)});
+    }
+
+    std::vector<position_change> changes;
+
+    for (auto& value : sorted_asset_values) {
+        auto& row_ids = value.liability ? liability_rows : asset_rows;
+
+        if (auto it = row_ids.find(value.asset_id); it != row_ids.end() && !rows[it->second].share_based) {
+            changes.push_back({value.set_date.day_number(), it->second, value.amount.value});
+        }
+    }
+
+    for (size_t row = 0; row < rows.size(); ++row) {
+        if (rows[row].share_based) {
+            for (auto& position : share_positions.positions(rows[row].id)) {
+                changes.push_back({position.date.day_number(), row, position.shares});
+            }
+        }
+    }
+
+    if (changes.empty()) {
+        return;
+    }
+
+    // The values are already sorted by date and the last value of a day wins
+    std::stable_sort(changes.begin(), changes.end(), [](auto& lhs, auto& rhs) { return lhs.day < rhs.day; });
+
+    std::vector<int64_t> current(rows.size(), 0);
+
+    for (auto it = changes.begin(); it != changes.end();) {
+        auto day = it->day;
+
+        for (; it != changes.end() && it->day == day; ++it) {
+            current[it->row] = it->amount;
+        }
+
+        days.push_back(day);
+        positions.insert(positions.end(), current.begin(), current.end());
+    }
+}
+
+int64_t budget::net_worth_series::position(size_t row, budget::date d) const {
+    // The positions do not change until the next change day
+    auto it = std::upper_bound(days.begin(), days.end(), d.day_number());
+
+    if (it == days.begin()) {
+        return 0;
+    }
+
+    size_t index = std::distance(days.begin(), it) - 1;
+
+    return positions[index * rows.size() + row];
+}
+
+budget::money budget::net_worth_series::value(size_t row, budget::date d) const {
+    auto& r = rows[row];
+
+    auto p = position(row, d);
+
+    if (r.share_based) {
+        if (p > 0) {
+            return static_cast<int>(p) * share_price(r.ticker, d);
+        }
+
+        return {};
+    }
+
+    budget::money amount;
+    amount.value = p;
+    return amount;
+}
+
+budget::money budget::net_worth_series::asset_value(const budget::asset& asset, budget::date d) const {
+    if (auto it = asset_rows.find(asset.id); it != asset_rows.end()) {
+        return value(it->second, d);
+    }
+
+    return {};
+}
+
+budget::money budget::net_worth_series::liability_value(const budget::liability& liability, budget::date d) const {
+    if (auto it = liability_rows.find(liability.id); it != liability_rows.end()) {
+        return value(it->second, d);
+    }
+
+    return {};
+}
+
+int64_t budget::net_worth_series::asset_shares(const budget::asset& asset, budget::date d) const {
+    if (auto it = asset_rows.find(asset.id); it != asset_rows.end() && rows[it->second].share_based) {
+        return position(it->second, d);
+    }
+
+    return 0;
+}
+
+budget::money budget::net_worth_series::net_worth(budget::date d) const {
+    // The rates and prices of today may still change
+    const bool past = d < budget::local_day();
+
+    if (past) {
+        std::lock_guard<std::mutex> l(net_worths->lock);
+
+        if (auto it = net_worths->values.find(d.day_number()); it != net_worths->values.end()) {
+            return it->second;
+        }
+    }
+
+    budget::money total;
+
+    for (size_t row = 0; row < rows.size(); ++row) {
+        if (!rows[row].counted) {
+            continue;
+        }
+
+        auto amount = value(row, d);
+
+        if (amount) {
+            amount = amount * rows[row].rate.rate(d);
+        }
+
+        if (rows[row].liability) {
+            total -= amount;
+        } else {
+            total += amount;
+        }
+    }
+
+    if (past) {
+        std::lock_guard<std::mutex> l(net_worths->lock);
+        net_worths->values[d.day_number()] = total;
+    }
+
+    return total;
+}
+
+void budget::net_worth_series::prefetch(const std::vector<budget::date>& dates) const {
+    std::vector<std::pair<std::string, budget::date>> prices;
+    std::vector<std::pair<currency_pair, budget::date>> rates;
+
+    for (auto& d : dates) {
+        for (size_t row = 0; row < rows.size(); ++row) {
+            auto p = position(row, d);
+
+            if (!rows[row].counted || p == 0 || (rows[row].share_based && p < 0)) {
+                continue;
+            }
+
+            if (rows[row].share_based) {
+                prices.emplace_back(rows[row].ticker, d);
+            }
+
+            rates.emplace_back(rows[row].rate, d);
+        }
+    }
+
+    prefetch_share_prices(prices);
+    prefetch_exchange_rates(rates);
+}
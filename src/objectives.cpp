@@ -216,13 +216,6 @@ int budget::compute_success(const budget::status& status, const budget::objectiv
     return success;
 }
 
-void budget::objectives_module::load(){
-    load_expenses();
-    load_earnings();
-    load_accounts();
-    load_objectives();
-}
-
 void budget::objectives_module::unload(){
     save_objectives();
 }
@@ -264,7 +257,7 @@ void budget::objectives_module::handle(const std::vector<std::string>& args){
 
             size_t id = to_number<size_t>(args[2]);
 
-            auto objective = objectives[id];
+            budget::objective objective = objectives[id];
 
             edit(objective);
 
@@ -311,7 +304,7 @@ void budget::objective::load(data_reader & reader){
     }
 }
 
-std::vector<objective> budget::all_objectives(){
+data_snapshot<objective> budget::all_objectives(){
     return objectives.data();
 }
 
@@ -6,8 +6,9 @@
 //=======================================================================
 
 #include <cstdio>
-#include <cstring>
+#include <limits>
 #include <numeric>
+#include <string_view>
 #include <unordered_map>
 #include <unordered_set>
 
@@ -20,6 +21,7 @@
 #include "budget_exception.hpp"
 #include "config.hpp"
 #include "writer.hpp"
+#include "string_table.hpp"
 
 using namespace budget;
 
@@ -32,7 +34,10 @@ bool invalid_accounts_all(){
 
     auto today = budget::local_day();
 
-    std::vector<budget::account> previous = all_accounts(cache, sy, start_month(cache, sy));
+    auto& index = cache.accounts_index();
+
+    budget::date previous_date(sy, start_month(cache, sy), 5);
+    auto previous = index.active(previous_date);
 
     for(unsigned short j = sy; j <= today.year(); ++j){
         budget::year year = j;
@@ -49,16 +54,7 @@ bool invalid_accounts_all(){
             }
 
             for(auto& c : current_accounts){
-                bool found = false;
-
-                for(auto& p : previous){
-                    if(p.name == c.name){
-                        found = true;
-                        break;
-                    }
-                }
-
-                if(!found){
+                if(!index.find(c.name, previous_date)){
                     return true;
                 }
             }
@@ -73,7 +69,10 @@ bool invalid_accounts(budget::year year){
 
     auto sm = start_month(cache, year);
 
-    std::vector<budget::account> previous = all_accounts(cache, year, sm);;
+    auto& index = cache.accounts_index();
+
+    budget::date previous_date(year, sm, 5);
+    auto previous = index.active(previous_date);
 
     for(unsigned short i = sm + 1; i < 13; ++i){
         budget::month month = i;
@@ -85,21 +84,13 @@ bool invalid_accounts(budget::year year){
         }
 
         for(auto& c : current_accounts){
-            bool found = false;
-
-            for(auto& p : previous){
-                if(p.name == c.name){
-                    found = true;
-                    break;
-                }
-            }
-
-            if(!found){
+            if(!index.find(c.name, previous_date)){
                 return true;
             }
         }
 
-        previous = std::move(current_accounts);
+        previous      = current_accounts;
+        previous_date = budget::date(year, month, 5);
     }
 
     return false;
@@ -154,8 +145,8 @@ budget::money compute_total_budget_account(budget::account & account, budget::mo
             for(auto& prev_account : all_accounts(cache, y, m)){
                 if (prev_account.name == account.name) {
                     total += prev_account.amount;
-                    total -= accumulate_amount(all_expenses_month(cache, prev_account.id, y, m));
-                    total += accumulate_amount(all_earnings_month(cache, prev_account.id, y, m));
+                    total -= cache.totals().account_expenses(prev_account.id, y, m);
+                    total += cache.totals().account_earnings(prev_account.id, y, m);
 
                     break;
                 }
@@ -203,8 +194,8 @@ std::vector<budget::money> compute_total_budget(data_cache & cache, budget::mont
 
             for(auto& account : all_accounts(cache, y, m)){
                 tmp[account.name] += account.amount;
-                tmp[account.name] -= accumulate_amount(all_expenses_month(cache, account.id, y, m));
-                tmp[account.name] += accumulate_amount(all_earnings_month(cache, account.id, y, m));
+                tmp[account.name] -= cache.totals().account_expenses(account.id, y, m);
+                tmp[account.name] += cache.totals().account_earnings(account.id, y, m);
             }
 
             if(y != year && m == 12){
@@ -242,8 +233,8 @@ void add_values_column(budget::month                            month,
 
     for (auto& expense : sorted_values) {
         if (expense.date.year() == year && expense.date.month() == month) {
-            if (indexes.count(get_account(expense.account).name)) {
-                size_t index = indexes[get_account(expense.account).name];
+            if (auto it = indexes.find(get_account(expense.account)->name); it != indexes.end()) {
+                size_t index = it->second;
                 size_t& row  = current[index];
 
                 if (contents.size() <= row) {
@@ -266,55 +257,74 @@ void add_values_column(budget::month                            month,
     add_recap_line(contents, title, total);
 }
 
-struct icompare_str {
-    bool operator()(const std::string& lhs, const std::string& rhs) const {
-        // Note: This is very fast, but not very good for locale
-        return strcasecmp(lhs.c_str(), rhs.c_str()) == 0;
-    }
+using acc_data_t = std::unordered_map<std::string, std::unordered_map<std::string, budget::money>>;
 
-    size_t operator()(const std::string& value) const {
-        auto l_value = value;
-        std::transform(l_value.begin(), l_value.end(), l_value.begin(), ::tolower);
-        std::hash<std::string> hasher;
-        return hasher(l_value);
-    }
-};
+std::pair<budget::money, acc_data_t> aggregate(data_cache& cache, const transactions& values, std::pair<size_t, size_t> range, bool full, bool disable_groups, const std::string& separator){
+    constexpr uint32_t no_group = std::numeric_limits<uint32_t>::max();
 
-using acc_data_t = std::unordered_map<std::string, std::unordered_map<std::string, budget::money, icompare_str, icompare_str>>;
+    auto& table = budget::names();
 
-template<typename Data, typename Functor>
-std::pair<budget::money, acc_data_t> aggregate(const Data & data, bool full, bool disable_groups, const std::string& separator, Functor&& func){
-    budget::money total;
-    acc_data_t acc_data;
+    // The group of each name is computed the first time it is seen. Groups
+    // are compared without case through the lower case version of the name,
+    // which is in the table as well, so the keys need no copy.
+    std::vector<uint32_t> groups(table.size(), no_group);
+    std::unordered_map<std::string_view, uint32_t> group_ids;
+    std::vector<std::string_view> group_names;
+
+    // The sums, in cents, by account and group
+    std::unordered_map<uint64_t, int64_t> sums;
+    int64_t total = 0;
 
     //Accumulate all the data
-    for (auto& data : data) {
-        if (func(data)) {
-            auto name = data.name;
+    for (size_t i = range.first; i < range.second; ++i) {
+        auto name = values.names[i];
 
-            if (name[name.size() - 1] == ' ') {
-                name.erase(name.size() - 1, name.size());
+        if (groups[name] == no_group) {
+            std::string_view group = table.str(name);
+
+            if (!group.empty() && group.back() == ' ') {
+                group.remove_suffix(1);
             }
 
             if (!disable_groups) {
-                auto loc = name.find(separator);
-                if (loc != std::string::npos) {
-                    name = name.substr(0, loc);
+                auto loc = group.find(separator);
+                if (loc != std::string_view::npos) {
+                    group = group.substr(0, loc);
                 }
             }
 
-            if (full) {
-                acc_data["All accounts"][name] += data.amount;
-            } else {
-                auto account = get_account(data.account);
-                acc_data[account.name][name] += data.amount;
+            auto folded = std::string_view(table.str(table.folded(name))).substr(0, group.size());
+
+            auto [it, inserted] = group_ids.try_emplace(folded, group_names.size());
+
+            if (inserted) {
+                group_names.push_back(group);
             }
 
-            total += data.amount;
+            groups[name] = it->second;
         }
+
+        uint64_t account = full ? 0 : values.accounts[i];
+        sums[(account << 32) | groups[name]] += values.amounts[i];
+        total += values.amounts[i];
+    }
+
+    acc_data_t acc_data;
+    std::unordered_map<uint32_t, std::string> account_names;
+
+    for (auto& [key, cents] : sums) {
+        uint32_t account = key >> 32;
+
+        if (!account_names.count(account)) {
+            account_names[account] = full ? "All accounts" : get_account(account)->name;
+        }
+
+        budget::money amount;
+        amount.value = cents;
+
+        acc_data[account_names[account]][std::string(group_names[static_cast<uint32_t>(key)])] += amount;
     }
 
-    data_cache cache;
     for (auto& account : current_accounts(cache)) {
         auto it = acc_data.find(account.name);
 
@@ -323,12 +333,14 @@ std::pair<budget::money, acc_data_t> aggregate(const Data & data, bool full, boo
         }
     }
 
-    return {total, acc_data};
+    budget::money total_amount;
+    total_amount.value = total;
+
+    return {total_amount, acc_data};
 }
 
-template<typename Data, typename Functor>
-void aggregate_overview(const Data & data, budget::writer& w, bool full, bool disable_groups, const std::string& separator, Functor&& func){
-    auto [total, acc_data] = aggregate(data, full, disable_groups, separator, func);
+void aggregate_overview(const transactions& values, std::pair<size_t, size_t> range, budget::writer& w, bool full, bool disable_groups, const std::string& separator){
+    auto [total, acc_data] = aggregate(w.cache, values, range, full, disable_groups, separator);
 
     std::unordered_map<std::string, budget::money> totals;
 
@@ -383,8 +395,7 @@ void aggregate_overview(const Data & data, budget::writer& w, bool full, bool di
     w.display_table(columns, contents, 3);
 }
 
-template<typename Data, typename Functor>
-void aggregate_overview_month(const Data & data, budget::writer& w, bool full, bool disable_groups, const std::string& separator, budget::year year, Functor&& func){
+void aggregate_overview_month(const transactions& values, std::pair<size_t, size_t> range, budget::writer& w, bool full, bool disable_groups, const std::string& separator, budget::year year){
     int months;
     if (year == budget::local_day().year()) {
         months = budget::local_day().month();
@@ -392,7 +403,7 @@ void aggregate_overview_month(const Data & data, budget::writer& w, bool full, b
         months = 12 - budget::start_month(w.cache, year) + 1;
     }
 
-    auto [total, acc_data] = aggregate(data, full, disable_groups, separator, func);
+    auto [total, acc_data] = aggregate(w.cache, values, range, full, disable_groups, separator);
 
     std::unordered_map<std::string, budget::money> totals;
 
@@ -457,9 +468,8 @@ budget::money future_value(budget::money start) {
     return value;
 }
 
-template<typename Data, typename Functor>
-void aggregate_overview_fv(const Data & data, budget::writer& w, bool full, bool disable_groups, const std::string& separator, Functor&& func){
-    auto [total, acc_data] = aggregate(data, full, disable_groups, separator, func);
+void aggregate_overview_fv(const transactions& values, std::pair<size_t, size_t> range, budget::writer& w, bool full, bool disable_groups, const std::string& separator){
+    auto [total, acc_data] = aggregate(w.cache, values, range, full, disable_groups, separator);
 
     std::unordered_map<std::string, budget::money> totals;
 
@@ -613,7 +623,7 @@ void display_values(budget::writer& w, budget::year year, const std::string& tit
 
             for(auto& value : values){
                 if(relaxed){
-                    if(get_account(value.account).name == account.name && value.date.year() == year && value.date.month() == m){
+                    if(get_account(value.account)->name == account.name && value.date.year() == year && value.date.month() == m){
                         month_total += value.amount;
                     }
                 } else {
@@ -692,18 +702,6 @@ void display_values(budget::writer& w, budget::year year, const std::string& tit
 
 constexpr const std::array<std::pair<const char*, const char*>, 1> budget::module_traits<budget::overview_module>::aliases;
 
-void budget::overview_module::load(){
-    load_accounts();
-    load_incomes();
-    load_expenses();
-    load_earnings();
-
-    // Yearly overview needs net worth data
-    load_earnings();
-    load_fortunes();
-    load_assets();
-}
-
 void budget::overview_module::handle(std::vector<std::string>& args) {
     if (no_accounts()) {
         throw budget_exception("No accounts defined, you should start by defining some of them");
@@ -858,11 +856,11 @@ void budget::overview_module::handle(std::vector<std::string>& args) {
 }
 
 void budget::display_expenses(budget::writer& w, budget::year year, bool current, bool relaxed, bool last){
-    display_values(w, year, "Expenses", all_expenses(), current, relaxed, last);
+    display_values(w, year, "Expenses", all_expenses().get(), current, relaxed, last);
 }
 
 void budget::display_earnings(budget::writer& w, budget::year year, bool current, bool relaxed, bool last){
-    display_values(w, year, "Earnings", all_earnings(), current, relaxed, last);
+    display_values(w, year, "Earnings", all_earnings().get(), current, relaxed, last);
 }
 
 void budget::display_local_balance(budget::writer& w, budget::year year, bool current, bool relaxed, bool last){
@@ -907,11 +905,11 @@ void budget::display_local_balance(budget::writer& w, budget::year year, bool cu
             budget::money total_earnings;
 
             if(relaxed){
-                total_expenses = accumulate_amount_if(w.cache.expenses(), [account,year,m](const budget::expense& e){return get_account(e.account).name == account.name && e.date.year() == year && e.date.month() == m;});
-                total_earnings = accumulate_amount_if(w.cache.earnings(), [account,year,m](const budget::earning& e){return get_account(e.account).name == account.name && e.date.year() == year && e.date.month() == m;});
+                total_expenses = w.cache.totals().account_expenses(account.name, year, m);
+                total_earnings = w.cache.totals().account_earnings(account.name, year, m);
             } else {
-                total_expenses = accumulate_amount_if(w.cache.expenses(), [account,year,m](const budget::expense& e){return e.account == account.id && e.date.year() == year && e.date.month() == m;});
-                total_earnings = accumulate_amount_if(w.cache.earnings(), [account,year,m](const budget::earning& e){return e.account == account.id && e.date.year() == year && e.date.month() == m;});
+                total_expenses = w.cache.totals().account_expenses(account.id, year, m);
+                total_earnings = w.cache.totals().account_earnings(account.id, year, m);
             }
 
             auto month_total = account.amount - total_expenses + total_earnings;
@@ -1090,11 +1088,11 @@ void budget::display_balance(budget::writer& w, budget::year year, bool relaxed,
             budget::money total_earnings;
 
             if(relaxed){
-                total_expenses = accumulate_amount_if(w.cache.expenses(), [account,year,m](const budget::expense& e){return get_account(e.account).name == account.name && e.date.year() == year && e.date.month() == m;});
-                total_earnings = accumulate_amount_if(w.cache.earnings(), [account,year,m](const budget::earning& e){return get_account(e.account).name == account.name && e.date.year() == year && e.date.month() == m;});
+                total_expenses = w.cache.totals().account_expenses(account.name, year, m);
+                total_earnings = w.cache.totals().account_earnings(account.name, year, m);
             } else {
-                total_expenses = accumulate_amount_if(w.cache.expenses(), [account,year,m](const budget::expense& e){return e.account == account.id && e.date.year() == year && e.date.month() == m;});
-                total_earnings = accumulate_amount_if(w.cache.earnings(), [account,year,m](const budget::earning& e){return e.account == account.id && e.date.year() == year && e.date.month() == m;});
+                total_expenses = w.cache.totals().account_expenses(account.id, year, m);
+                total_earnings = w.cache.totals().account_earnings(account.id, year, m);
             }
 
             auto month_total = account_previous[account.name][i - 1] + account.amount - total_expenses + total_earnings;
@@ -1154,7 +1152,7 @@ void budget::display_month_overview(budget::month month, budget::year year, budg
 
     //Budget
     contents.emplace_back(columns.size() * 3, "");
-    add_recap_line(contents, "Budget", accounts, [](const budget::account& a){return format_money(a.amount);});
+    add_recap_line(contents, "Budget", accounts.to_vector(), [](const budget::account& a){return format_money(a.amount);});
     auto total_budgets = compute_total_budget(writer.cache, month, year);
     add_recap_line(contents, "Total Budget", total_budgets, [](const budget::money& m){ return format_money(m);});
 
@@ -1238,6 +1236,8 @@ void budget::display_month_overview(budget::month month, budget::year year, budg
     budget::date month_start(year, month, 1);
     budget::date month_end = month_start.end_of_month();
 
+    writer.cache.net_worth().prefetch({month_start, month_end});
+
     auto net_worth_end = get_net_worth(month_end, writer.cache);
     auto net_worth_month_start = get_net_worth(month_start, writer.cache);
 
@@ -1255,9 +1255,7 @@ void budget::display_month_overview(budget::month month, budget::year year, budg
 }
 
 void budget::display_month_account_overview(size_t account_id, budget::month month, budget::year year, budget::writer& writer){
-    auto account = get_account(account_id);
-
-    auto accounts = all_accounts(writer.cache, year, month);
+    budget::account account = get_account(account_id);
 
     writer << title_begin << "Account Overview of " << month << " " << year << budget::year_month_selector{"account_overview", year, month} << title_end;
 
@@ -1347,9 +1345,12 @@ void budget::display_year_overview_header(budget::year year, budget::writer& w){
     }
 
     budget::date  year_start(year, 1, 1);
+    budget::date  prev_year_start(prev_year, 1, 1);
+
+    w.cache.net_worth().prefetch({year_start, year_start.end_of_year(), prev_year_start, prev_year_start.end_of_year()});
+
     budget::money year_increase = get_net_worth(year_start.end_of_year(), w.cache) - get_net_worth(year_start, w.cache);
 
-    budget::date  prev_year_start(prev_year, 1, 1);
     budget::money prev_year_increase = get_net_worth(prev_year_start.end_of_year(), w.cache) - get_net_worth(prev_year_start, w.cache);
 
     contents.push_back({"Net Worth Increase",
@@ -1393,11 +1394,14 @@ void budget::aggregate_all_overview(budget::writer& w, bool full, bool disable_g
 
     w << title_begin << "Aggregate overview of all time" << title_end;
 
+    auto& expenses = w.cache.expense_transactions();
+    auto& earnings = w.cache.earning_transactions();
+
     w << p_begin << "Expenses" << p_end;
-    aggregate_overview(all_expenses(), w, full, disable_groups, separator, [](const budget::expense& /*expense*/){ return true; });
+    aggregate_overview(expenses, {0, expenses.size()}, w, full, disable_groups, separator);
 
     w << p_begin << "Earnings" << p_end;
-    aggregate_overview(all_earnings(), w, full, disable_groups, separator, [](const budget::earning& /*earning*/){ return true; });
+    aggregate_overview(earnings, {0, earnings.size()}, w, full, disable_groups, separator);
 }
 
 void budget::aggregate_year_overview(budget::writer& w, bool full, bool disable_groups, const std::string& separator, budget::year year){
@@ -1407,11 +1411,17 @@ void budget::aggregate_year_overview(budget::writer& w, bool full, bool disable_
 
     w << title_begin << "Aggregate overview of " << year << year_selector{"overview/aggregate/year", year} << title_end;
 
+    budget::date first(year, 1, 1);
+    budget::date last(year, 12, 31);
+
+    auto& expenses = w.cache.expense_transactions();
+    auto& earnings = w.cache.earning_transactions();
+
     w << p_begin << "Expenses" << p_end;
-    aggregate_overview(all_expenses(), w, full, disable_groups, separator, [year](const budget::expense& expense){ return expense.date.year() == year; });
+    aggregate_overview(expenses, expenses.between(first, last), w, full, disable_groups, separator);
 
     w << p_begin << "Earnings" << p_end;
-    aggregate_overview(all_earnings(), w, full, disable_groups, separator, [year](const budget::earning& earning){ return earning.date.year() == year; });
+    aggregate_overview(earnings, earnings.between(first, last), w, full, disable_groups, separator);
 }
 
 void budget::aggregate_year_month_overview(budget::writer& w, bool full, bool disable_groups, const std::string& separator, budget::year year){
@@ -1421,11 +1431,17 @@ void budget::aggregate_year_month_overview(budget::writer& w, bool full, bool di
 
     w << title_begin << "Aggregate overview of " << year << year_selector{"overview/aggregate/year_month", year} << title_end;
 
+    budget::date first(year, 1, 1);
+    budget::date last(year, 12, 31);
+
+    auto& expenses = w.cache.expense_transactions();
+    auto& earnings = w.cache.earning_transactions();
+
     w << p_begin << "Expenses" << p_end;
-    aggregate_overview_month(all_expenses(), w, full, disable_groups, separator, year, [year](const budget::expense& expense){ return expense.date.year() == year; });
+    aggregate_overview_month(expenses, expenses.between(first, last), w, full, disable_groups, separator, year);
 
     w << p_begin << "Earnings" << p_end;
-    aggregate_overview_month(all_earnings(), w, full, disable_groups, separator, year, [year](const budget::earning& earning){ return earning.date.year() == year; });
+    aggregate_overview_month(earnings, earnings.between(first, last), w, full, disable_groups, separator, year);
 }
 
 void budget::aggregate_year_fv_overview(budget::writer& w, bool full, bool disable_groups, const std::string& separator, budget::year year){
@@ -1435,21 +1451,33 @@ void budget::aggregate_year_fv_overview(budget::writer& w, bool full, bool disab
 
     w << title_begin << "Aggregate FV overview of " << year << year_selector{"overview/aggregate/year_fv", year} << title_end;
 
+    budget::date first(year, 1, 1);
+    budget::date last(year, 12, 31);
+
+    auto& expenses = w.cache.expense_transactions();
+    auto& earnings = w.cache.earning_transactions();
+
     w << p_begin << "Expenses" << p_end;
-    aggregate_overview_fv(all_expenses(), w, full, disable_groups, separator, [year](const budget::expense& expense){ return expense.date.year() == year; });
+    aggregate_overview_fv(expenses, expenses.between(first, last), w, full, disable_groups, separator);
 
     w << p_begin << "Earnings" << p_end;
-    aggregate_overview_fv(all_earnings(), w, full, disable_groups, separator, [year](const budget::earning& earning){ return earning.date.year() == year; });
+    aggregate_overview_fv(earnings, earnings.between(first, last), w, full, disable_groups, separator);
 }
 
 void budget::aggregate_month_overview(budget::writer& w, bool full, bool disable_groups, const std::string& separator, budget::month month, budget::year year){
     w << title_begin << "Aggregate overview of " << month << " " << year << year_month_selector{"overview/aggregate/month", year, month} << title_end;
 
+    budget::date first(year, month, 1);
+    auto last = first.end_of_month();
+
+    auto& expenses = w.cache.expense_transactions();
+    auto& earnings = w.cache.earning_transactions();
+
     w << p_begin << "Expenses" << p_end;
-    aggregate_overview(all_expenses(), w, full, disable_groups, separator, [month,year](const budget::expense& expense){ return expense.date.month() == month && expense.date.year() == year; });
+    aggregate_overview(expenses, expenses.between(first, last), w, full, disable_groups, separator);
 
     w << p_begin << "Earnings" << p_end;
-    aggregate_overview(all_earnings(), w, full, disable_groups, separator, [month,year](const budget::earning& earning){ return earning.date.month() == month && earning.date.year() == year; });
+    aggregate_overview(earnings, earnings.between(first, last), w, full, disable_groups, separator);
 }
 
 void budget::add_expenses_column(budget::month                            month,
@@ -54,14 +54,14 @@ void predict_overview(){
     }
 
     for(auto& expense : expenses){
-        if(account_mappings.count(get_account(expense.account).name)){
-            expense.amount *= (expense_multipliers[account_mappings[get_account(expense.account).name]] / 100.0);
+        if(account_mappings.count(get_account(expense.account)->name)){
+            expense.amount *= (expense_multipliers[account_mappings[get_account(expense.account)->name]] / 100.0);
         }
     }
 
     for(auto& earning : earnings){
-        if(account_mappings.count(get_account(earning.account).name)){
-            earning.amount *= (earning_multipliers[account_mappings[get_account(earning.account).name]] / 100.0);
+        if(account_mappings.count(get_account(earning.account)->name)){
+            earning.amount *= (earning_multipliers[account_mappings[get_account(earning.account)->name]] / 100.0);
         }
     }
 
@@ -92,12 +92,6 @@ void predict_overview(){
 
 } // end of anonymous namespace
 
-void budget::predict_module::load(){
-    load_accounts();
-    load_expenses();
-    load_earnings();
-}
-
 void budget::predict_module::handle(std::vector<std::string>& args){
     if(no_accounts()){
         throw budget_exception("No accounts defined, you should start by defining some of them");
@@ -0,0 +1,211 @@
+//=======================================================================
+// Copyright (c) 2013-2020 Baptiste Wicht.
+// Distributed under the terms of the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "price_cache.hpp"
+#include "logging.hpp"
+
+using namespace budget;
+
+namespace {
+
+// Layout of a price cache file (all integers are native-endian):
+//
+// header  : magic (16 bytes)
+// records : key (u32), day (u32), value (i64)
+//
+// A record with a day of zero defines the key: its value is the length
+// of the name of the key, which is stored in the following records,
+// padded with zeroes.
+
+constexpr const char price_cache_magic[16] = {'B', 'U', 'D', 'G', 'E', 'T', 'P', 'R', 'I', 'C', 'E', 'S', '1', 0, 0, 0};
+
+constexpr size_t record_size = sizeof(price_record);
+
+static_assert(record_size == 16, "The records of the price cache must be packed");
+static_assert(sizeof(price_cache_magic) == record_size, "The header must be one record");
+
+size_t name_records(size_t length) {
+    return (length + record_size - 1) / record_size;
+}
+
+} // end of anonymous namespace
+
+budget::price_cache_file::price_cache_file(std::string path) : path(std::move(path)) {}
+
+bool budget::price_cache_file::load(std::vector<price_record>& records) {
+    const char* data = nullptr;
+    size_t size      = 0;
+
+    std::vector<char> buffer;
+
+#ifndef _WIN32
+    void* mapping = MAP_FAILED;
+
+    int fd = ::open(path.c_str(), O_RDONLY);
+
+    if (fd >= 0) {
+        struct stat st;
+
+        if (::fstat(fd, &st) == 0 && st.st_size > 0) {
+            mapping = ::mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+            if (mapping != MAP_FAILED) {
+                data = static_cast<const char*>(mapping);
+                size = st.st_size;
+            }
+        }
+
+        ::close(fd);
+    }
+#endif
+
+    // If the file could not be mapped, we simply read it in memory
+    if (!data) {
+        std::ifstream file(path, std::ios::binary);
+
+        if (file.is_open()) {
+            buffer.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+            data = buffer.data();
+            size = buffer.size();
+        }
+    }
+
+    bool valid = size >= record_size && std::memcmp(data, price_cache_magic, record_size) == 0;
+
+    if (valid) {
+        size_t offset = record_size;
+
+        while (offset + record_size <= size) {
+            price_record record;
+            std::memcpy(&record, data + offset, record_size);
+
+            if (record.day) {
+                if (record.key >= keys.size()) {
+                    LOG_F(ERROR, "The price cache {} refers to an unknown key", path);
+                    break;
+                }
+
+                records.push_back(record);
+                offset += record_size;
+            } else {
+                auto length = static_cast<size_t>(record.value);
+
+                if (record.key != keys.size() || offset + (1 + name_records(length)) * record_size > size) {
+                    break;
+                }
+
+                ids[keys.emplace_back(data + offset + record_size, length)] = record.key;
+                offset += (1 + name_records(length)) * record_size;
+            }
+        }
+
+        // A partially written record at the end is ignored and overwritten
+        valid_size   = offset;
+        written_keys = keys.size();
+    }
+
+#ifndef _WIN32
+    if (mapping != MAP_FAILED) {
+        ::munmap(mapping, size);
+    }
+#endif
+
+    return valid;
+}
+
+const std::string& budget::price_cache_file::key(uint32_t id) const {
+    return keys[id];
+}
+
+uint32_t budget::price_cache_file::key_id(const std::string& key) {
+    if (auto it = ids.find(key); it != ids.end()) {
+        return it->second;
+    }
+
+    auto id = static_cast<uint32_t>(keys.size());
+
+    keys.push_back(key);
+    ids[key] = id;
+
+    return id;
+}
+
+bool budget::price_cache_file::append(const std::vector<price_record>& records) {
+    std::string out;
+
+    if (!valid_size) {
+        out.append(price_cache_magic, record_size);
+        written_keys = 0;
+    }
+
+    for (; written_keys < keys.size(); ++written_keys) {
+        auto& name = keys[written_keys];
+
+        price_record definition{static_cast<uint32_t>(written_keys), 0, static_cast<int64_t>(name.size())};
+
+        out.append(reinterpret_cast<const char*>(&definition), record_size);
+        out.append(name);
+        out.resize(out.size() + name_records(name.size()) * record_size - name.size(), '\0');
+    }
+
+    for (auto& record : records) {
+        out.append(reinterpret_cast<const char*>(&record), record_size);
+    }
+
+    {
+        std::fstream file;
+
+        if (valid_size) {
+#ifndef _WIN32
+            // Drop what remains of an interrupted append
+            if (::truncate(path.c_str(), valid_size) != 0) {
+                LOG_F(ERROR, "Impossible to truncate the price cache {}", path);
+                return false;
+            }
+#endif
+
+            file.open(path, std::ios::binary | std::ios::in | std::ios::out);
+            file.seekp(valid_size);
+        } else {
+            file.open(path, std::ios::binary | std::ios::out | std::ios::trunc);
+        }
+
+        file.write(out.data(), out.size());
+
+        if (!file.good()) {
+            LOG_F(ERROR, "Impossible to write the price cache {}", path);
+            return false;
+        }
+    }
+
+    valid_size += out.size();
+
+    return true;
+}
+
+bool budget::is_price_cache_file(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+
+    char magic[record_size];
+
+    if (!file.read(magic, sizeof(magic))) {
+        return false;
+    }
+
+    return std::memcmp(magic, price_cache_magic, record_size) == 0;
+}
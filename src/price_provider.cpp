@@ -0,0 +1,169 @@
+//=======================================================================
+// Copyright (c) 2013-2020 Baptiste Wicht.
+// Distributed under the terms of the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+#include "price_provider.hpp"
+#include "price_cache.hpp"
+#include "utils.hpp"
+#include "logging.hpp"
+
+using namespace budget;
+
+budget::file_price_provider::file_price_provider(std::string path) : path(std::move(path)) {}
+
+void budget::file_price_provider::read_text() {
+    std::ifstream file(path);
+
+    if (!file.is_open() || !file.good()) {
+        LOG_F(ERROR, "Price: Impossible to read prices from {}", path);
+        return;
+    }
+
+    std::string line;
+    while (getline(file, line)) {
+        if (line.empty()) {
+            continue;
+        }
+
+        auto parts = split(line, line.find(',') == std::string::npos ? ':' : ',');
+
+        try {
+            auto day = date_from_string(parts[0]).day_number();
+
+            if (parts.size() == 3) {
+                prices[parts[1]][day] = money::from_double(to_number<double>(parts[2])).value;
+            } else if (parts.size() == 4) {
+                exchanges[parts[1] + ':' + parts[2]][day] = to_number<double>(parts[3]);
+            } else {
+                LOG_F(ERROR, "Price: Invalid line in {}: {}", path, line);
+            }
+        } catch (const date_exception& e) {
+            LOG_F(ERROR, "Price: Invalid date in {}: {}", path, line);
+        }
+    }
+}
+
+void budget::file_price_provider::read_binary() {
+    price_cache_file file(path);
+
+    std::vector<price_record> records;
+    file.load(records);
+
+    // The keys of the exchange rates are "from:to", the values are the
+    // bits of the rates
+    for (auto& record : records) {
+        auto& key = file.key(record.key);
+
+        if (key.find(':') == std::string::npos) {
+            prices[key][record.day] = record.value;
+        } else {
+            double value;
+            std::memcpy(&value, &record.value, sizeof(value));
+            exchanges[key][record.day] = value;
+        }
+    }
+}
+
+void budget::file_price_provider::load() {
+    std::call_once(loaded, [this]() {
+        if (is_price_cache_file(path)) {
+            read_binary();
+        } else {
+            read_text();
+        }
+
+        LOG_F(INFO, "Price: Loaded the prices of {} tickers and the rates of {} pairs from {}", prices.size(), exchanges.size(), path);
+    });
+}
+
+size_t budget::file_price_provider::size() {
+    load();
+
+    size_t count = 0;
+
+    for (auto& [ticker, values] : prices) {
+        count += values.size();
+    }
+
+    for (auto& [pair, values] : exchanges) {
+        count += values.size();
+    }
+
+    return count;
+}
+
+std::map<budget::date, budget::money> budget::file_price_provider::quotes(const std::string& ticker, budget::date start, budget::date end) {
+    load();
+
+    std::map<budget::date, budget::money> quotes;
+
+    if (auto it = prices.find(ticker); it != prices.end()) {
+        auto& values = it->second;
+
+        for (auto value = values.lower_bound(start.day_number()); value != values.end() && value->first <= end.day_number(); ++value) {
+            budget::money price;
+            price.value = value->second;
+            quotes[budget::date::from_day_number(value->first)] = price;
+        }
+    }
+
+    return quotes;
+}
+
+bool budget::file_price_provider::rate(const std::string& from, const std::string& to, budget::date d, double& value) {
+    load();
+
+    // The rates of a pair are also the reverse of the rates of the reverse pair
+    for (bool reverse : {false, true}) {
+        auto it = exchanges.find(reverse ? to + ':' + from : from + ':' + to);
+
+        if (it == exchanges.end()) {
+            continue;
+        }
+
+        auto& values = it->second;
+
+        if (auto next = values.upper_bound(d.day_number()); next != values.begin()) {
+            value = std::prev(next)->second;
+
+            if (reverse) {
+                value = 1.0 / value;
+            }
+
+            return true;
+        }
+    }
+
+    return false;
+}
+
+std::map<budget::date, double> budget::file_price_provider::rates(const std::string& from, const std::string& to, budget::date start, budget::date end) {
+    load();
+
+    std::map<budget::date, double> rates;
+
+    for (bool reverse : {false, true}) {
+        auto it = exchanges.find(reverse ? to + ':' + from : from + ':' + to);
+
+        if (it == exchanges.end()) {
+            continue;
+        }
+
+        auto& values = it->second;
+
+        for (auto value = values.lower_bound(start.day_number()); value != values.end() && value->first <= end.day_number(); ++value) {
+            rates.emplace(budget::date::from_day_number(value->first), reverse ? 1.0 / value->second : value->second);
+        }
+    }
+
+    return rates;
+}
@@ -19,6 +19,7 @@
 #include "console.hpp"
 #include "budget_exception.hpp"
 #include "expenses.hpp"
+#include "loader.hpp"
 #include "earnings.hpp"
 #include "writer.hpp"
 
@@ -33,7 +34,7 @@ budget::date last_date(const budget::recurring& recurring) {
 
     if (recurring.type == "expense") {
         for (auto& expense : all_expenses()) {
-            if (expense.name == recurring.name && expense.amount == recurring.amount && get_account(expense.account).name == recurring.account) {
+            if (expense.name == recurring.name && expense.amount == recurring.amount && get_account(expense.account)->name == recurring.account) {
                 if (expense.date > last) {
                     last = expense.date;
                 }
@@ -41,7 +42,7 @@ budget::date last_date(const budget::recurring& recurring) {
         }
     } else if (recurring.type == "earning") {
         for (auto& earning : all_earnings()) {
-            if (earning.name == recurring.name && earning.amount == recurring.amount && get_account(earning.account).name == recurring.account) {
+            if (earning.name == recurring.name && earning.amount == recurring.amount && get_account(earning.account)->name == recurring.account) {
                 if (earning.date > last) {
                     last = earning.date;
                 }
@@ -187,9 +188,7 @@ void budget::recurring_module::preload() {
         return;
     }
 
-    load_recurrings();
-    load_accounts();
-    load_expenses();
+    load_concurrently({"recurrings", "accounts", "expenses"});
 
     check_for_recurrings();
 }
@@ -197,9 +196,7 @@ void budget::recurring_module::preload() {
 void budget::recurring_module::load() {
     // Only need to load in server mode
     if (is_server_mode()) {
-        load_recurrings();
-        load_accounts();
-        load_expenses();
+        load_concurrently({"recurrings", "accounts", "expenses"});
     }
 }
 
@@ -245,8 +242,8 @@ void budget::recurring_module::handle(const std::vector<std::string>& args) {
 
             size_t id = to_number<size_t>(args[2]);
 
-            auto recurring          = recurrings[id];
-            auto previous_recurring = recurring; // Temporary Copy
+            budget::recurring recurring = recurrings[id];
+            auto previous_recurring     = recurring; // Temporary Copy
 
             edit_string_complete(recurring.account, "Account", all_account_names(), not_empty_checker(), account_checker());
             edit_string(recurring.name, "Name", not_empty_checker());
@@ -301,7 +298,7 @@ void budget::recurring::load(data_reader & reader) {
     }
 }
 
-std::vector<recurring> budget::all_recurrings() {
+data_snapshot<recurring> budget::all_recurrings() {
     return recurrings.data();
 }
 
@@ -378,12 +375,13 @@ bool budget::edit_recurring(const budget::recurring& recurring, const budget::re
     if (recurring.type == "expense") {
         for (auto& expense : all_expenses()) {
             if (expense.date.year() == now.year() && expense.date.month() == now.month() && expense.name == previous_recurring.name
-                && expense.amount == previous_recurring.amount && get_account(expense.account).name == previous_recurring.account) {
-                expense.name    = recurring.name;
-                expense.amount  = recurring.amount;
-                expense.account = get_account(recurring.account, now.year(), now.month()).id;
+                && expense.amount == previous_recurring.amount && get_account(expense.account)->name == previous_recurring.account) {
+                auto edited    = expense;
+                edited.name    = recurring.name;
+                edited.amount  = recurring.amount;
+                edited.account = get_account(recurring.account, now.year(), now.month()).id;
 
-                edit_expense(expense);
+                edit_expense(edited);
 
                 break;
             }
@@ -393,12 +391,13 @@ bool budget::edit_recurring(const budget::recurring& recurring, const budget::re
     } else if (recurring.type == "earning") {
         for (auto& earning : all_earnings()) {
             if (earning.date.year() == now.year() && earning.date.month() == now.month() && earning.name == previous_recurring.name
-                && earning.amount == previous_recurring.amount && get_account(earning.account).name == previous_recurring.account) {
-                earning.name    = recurring.name;
-                earning.amount  = recurring.amount;
-                earning.account = get_account(recurring.account, now.year(), now.month()).id;
+                && earning.amount == previous_recurring.amount && get_account(earning.account)->name == previous_recurring.account) {
+                auto edited    = earning;
+                edited.name    = recurring.name;
+                edited.amount  = recurring.amount;
+                edited.account = get_account(recurring.account, now.year(), now.month()).id;
 
-                edit_earning(earning);
+                edit_earning(edited);
 
                 break;
             }
@@ -43,13 +43,6 @@ void write(graph_type& graph, int row, int col, const std::string& value) {
 
 } //end of anonymous namespace
 
-void budget::report_module::load() {
-    load_accounts();
-    load_expenses();
-    load_earnings();
-    load_incomes();
-}
-
 void budget::report_module::handle(const std::vector<std::string>& args) {
     auto today = budget::local_day();
 
@@ -105,8 +98,8 @@ void budget::report(budget::writer& w, budget::year year, bool filter, const std
 
             for (auto& account : all_accounts(w.cache, year, month)) {
                 if (!filter || account.name == filter_account) {
-                    auto expenses = accumulate_amount(all_expenses_month(w.cache, account.id, year, month));
-                    auto earnings = accumulate_amount(all_earnings_month(w.cache, account.id, year, month));
+                    auto expenses = w.cache.totals().account_expenses(account.id, year, month);
+                    auto earnings = w.cache.totals().account_earnings(account.id, year, month);
 
                     m_expenses += expenses;
                     m_earnings += earnings;
@@ -148,10 +141,8 @@ void budget::report(budget::writer& w, budget::year year, bool filter, const std
 
         for (auto& account : all_accounts(w.cache, year, month)) {
             if (!filter || account.name == filter_account) {
-                auto expenses = accumulate_amount_if(w.cache.expenses(),
-                                                     [year, month, account](const budget::expense& e) { return e.account == account.id && e.date.year() == year && e.date.month() == month; });
-                auto earnings = accumulate_amount_if(w.cache.earnings(),
-                                                     [year, month, account](const budget::earning& e) { return e.account == account.id && e.date.year() == year && e.date.month() == month; });
+                auto expenses = w.cache.totals().account_expenses(account.id, year, month);
+                auto earnings = w.cache.totals().account_earnings(account.id, year, month);
 
                 total_expenses += expenses;
                 total_earnings += earnings;
@@ -30,25 +30,9 @@ money running_expenses(data_cache & cache, budget::date d = budget::local_day())
     budget::date end = d - budget::days(d.day() - 1);
     budget::date start = end - budget::months(running_limit);
 
-    budget::money total;
+    auto & expenses = cache.expense_transactions();
 
-    auto & expenses = cache.sorted_expenses();
-
-    if (!expenses.empty()) {
-        auto it = std::lower_bound(expenses.begin(), expenses.end(), start, [](const auto & value, budget::date d) { return value.date < d; });
-
-        while (it != expenses.end()) {
-            if (it->date < end) {
-                total += it->amount;
-
-                ++it;
-            } else {
-                break;
-            }
-        }
-    }
-
-    return total;
+    return expenses.sum(expenses.between(start, end - budget::days(1)));
 }
 
 double running_savings_rate(data_cache & cache, budget::date sd = budget::local_day()){
@@ -57,8 +41,8 @@ double running_savings_rate(data_cache & cache, budget::date sd = budget::local_
     for(size_t i = 1; i <= running_limit; ++i){
         auto d = sd - budget::months(i);
 
-        auto expenses = accumulate_amount(all_expenses_month(cache, d.year(), d.month()));
-        auto earnings = accumulate_amount(all_earnings_month(cache, d.year(), d.month()));
+        auto expenses = cache.totals().expenses(d.year(), d.month());
+        auto earnings = cache.totals().earnings(d.year(), d.month());
         auto income   = get_base_income(cache, d);
 
         auto balance = income + earnings - expenses;
@@ -80,7 +64,7 @@ budget::money running_income(data_cache & cache, budget::date sd = budget::local
     for(size_t i = 1; i <= running_limit; ++i){
         auto d = sd - budget::months(i);
 
-        auto earnings = accumulate_amount(all_earnings_month(cache, d.year(), d.month()));
+        auto earnings = cache.totals().earnings(d.year(), d.month());
         income += get_base_income(cache, d) + earnings;
     }
 
@@ -109,13 +93,6 @@ void retirement_set() {
 
 } // end of anonymous namespace
 
-void budget::retirement_module::load() {
-    load_accounts();
-    load_assets();
-    load_expenses();
-    load_earnings();
-}
-
 void budget::retirement_module::handle(std::vector<std::string>& args) {
     console_writer w(std::cout);
 
@@ -0,0 +1,86 @@
+//=======================================================================
+// Copyright (c) 2013-2020 Baptiste Wicht.
+// Distributed under the terms of the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+#include <algorithm>
+
+#include "server_lock.hpp"
+#include "logging.hpp"
+
+using namespace budget;
+
+namespace {
+
+// The registry is a local static so that it is available to the locks
+// that are constructed during static initialization
+struct lock_registry {
+    std::mutex mutex;
+    std::vector<const server_lock*> locks;
+};
+
+lock_registry& registry() {
+    static lock_registry registry;
+    return registry;
+}
+
+} // end of anonymous namespace
+
+budget::server_lock::server_lock(const char* name) : name(name) {
+    auto& r = registry();
+
+    std::lock_guard<std::mutex> l(r.mutex);
+    r.locks.push_back(this);
+}
+
+budget::server_lock::~server_lock() {
+    auto& r = registry();
+
+    std::lock_guard<std::mutex> l(r.mutex);
+    r.locks.erase(std::remove(r.locks.begin(), r.locks.end(), this), r.locks.end());
+}
+
+budget::server_lock_stats budget::server_lock::stats() const {
+    server_lock_stats stats;
+
+    stats.name         = name;
+    stats.exclusive    = exclusive.load(std::memory_order_relaxed);
+    stats.shared       = shared.load(std::memory_order_relaxed);
+    stats.contended    = contended.load(std::memory_order_relaxed);
+    stats.wait_time_us = wait_time_us.load(std::memory_order_relaxed);
+    stats.max_wait_us  = max_wait_us.load(std::memory_order_relaxed);
+
+    return stats;
+}
+
+std::vector<budget::server_lock_stats> budget::all_server_lock_stats() {
+    auto& r = registry();
+
+    std::lock_guard<std::mutex> l(r.mutex);
+
+    std::vector<server_lock_stats> stats;
+    stats.reserve(r.locks.size());
+
+    for (auto* lock : r.locks) {
+        stats.push_back(lock->stats());
+    }
+
+    return stats;
+}
+
+void budget::log_server_lock_stats() {
+    for (auto& stats : all_server_lock_stats()) {
+        if (stats.contended) {
+            LOG_F(INFO,
+                  "Lock {}: {} exclusive, {} shared, {} contended, waited {}us (max {}us)",
+                  stats.name,
+                  stats.exclusive,
+                  stats.shared,
+                  stats.contended,
+                  stats.wait_time_us,
+                  stats.max_wait_us);
+        }
+    }
+}
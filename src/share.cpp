@@ -5,12 +5,18 @@
 //  http://opensource.org/licenses/MIT)
 //=======================================================================
 
-#include <tuple>
-#include <utility>
+#include <algorithm>
+#include <atomic>
+#include <fstream>
 #include <iostream>
-#include <sstream>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <set>
+#include <sstream>
+#include <tuple>
+#include <utility>
+#include <vector>
 
 #include "cpp_utils/string.hpp"
 
@@ -21,7 +27,10 @@
 #include "date.hpp"
 #include "money.hpp"
 #include "server_lock.hpp"
+#include "price_cache.hpp"
+#include "price_provider.hpp"
 #include "logging.hpp"
+#include "worker_pool.hpp"
 
 namespace {
 
@@ -40,8 +49,21 @@ struct share_price_cache_key {
     }
 };
 
-std::map<share_price_cache_key, budget::money> share_prices;
-budget::server_lock shares_lock;
+using quotes_map = std::map<share_price_cache_key, budget::money>;
+
+quotes_map share_prices;
+budget::server_lock shares_lock("share_prices");
+
+// The cache file is only read when a price is needed for the first time
+std::atomic<bool> cache_requested{false};
+std::once_flag cache_loaded;
+std::unique_ptr<budget::price_cache_file> cache_file; // Only when the file is in binary format
+
+// The valid prices fetched since the cache was loaded, guarded by shares_lock
+std::vector<std::pair<share_price_cache_key, budget::money>> pending;
+
+// The number of days fetched before and after the requested date
+constexpr size_t fetch_days = 10;
 
 budget::date get_valid_date(budget::date d){
     // We cannot get closing price in the future, so we use the day before date
@@ -85,58 +107,84 @@ std::string exec_command(const std::string& command) {
 }
 
 // V3 is using Yahoo Finance
-// Starting from this version, the get_share_price function must be thread
-// safe. This means, it cannot touch the cache itself
-std::map<share_price_cache_key, budget::money> get_share_price_v3(const std::string & ticker, budget::date start_date, budget::date end_date) {
-    std::string command = "yfinance_quote.py " + ticker + " " + date_to_string(start_date) + " " + date_to_string(end_date);
+// Starting from this version, the providers must be thread safe. This
+// means, they cannot touch the cache itself
+struct yfinance_provider : budget::share_price_provider {
+    std::map<budget::date, budget::money> quotes(const std::string& ticker, budget::date start_date, budget::date end_date) override {
+        std::string command = "yfinance_quote.py " + ticker + " " + date_to_string(start_date) + " " + date_to_string(end_date);
 
-    auto result = exec_command(command);
+        auto result = exec_command(command);
 
-    if (result.empty()) {
-        LOG_F(ERROR, "Price(v3): yfinance_quote.py returned nothing");
+        if (result.empty()) {
+            LOG_F(ERROR, "Price(v3): yfinance_quote.py returned nothing");
 
-        return {};
-    }
+            return {};
+        }
 
-    std::map<share_price_cache_key, budget::money> quotes;
+        std::map<budget::date, budget::money> quotes;
 
-    std::stringstream ss(result);
+        std::stringstream ss(result);
 
-    try {
-        std::string line;
-        while (getline(ss, line)) {
-            budget::data_reader reader;
-            reader.parse(line);
+        try {
+            std::string line;
+            while (getline(ss, line)) {
+                budget::data_reader reader;
+                reader.parse(line);
 
-            budget::date  d;
-            budget::money m;
+                budget::date  d;
+                budget::money m;
 
-            reader >> d;
-            reader >> m;
+                reader >> d;
+                reader >> m;
 
-            share_price_cache_key key(d, ticker);
-            quotes[key] = m;
+                quotes[d] = m;
+            }
+        } catch (const budget::date_exception& e) {
+            return {};
+        } catch (const budget::budget_exception& e) {
+            return {};
         }
-    } catch (const budget::date_exception& e) {
-        return {};
-    } catch (const budget::budget_exception& e) {
-        return {};
+
+        return quotes;
     }
+};
 
-    return quotes;
-}
+std::mutex provider_lock;
+std::shared_ptr<budget::share_price_provider> provider;
 
-} // end of anonymous namespace
+std::shared_ptr<budget::share_price_provider> get_provider() {
+    std::lock_guard<std::mutex> l(provider_lock);
 
-void budget::load_share_price_cache(){
-    std::string file_path = budget::path_to_budget_file("share_price.cache");
-    std::ifstream file(file_path);
+    if (!provider) {
+        if (budget::config_value("share_price_provider", "yfinance") == "file") {
+            provider = std::make_shared<budget::file_price_provider>(budget::config_value("share_price_file", budget::path_to_budget_file("share_prices.csv")));
+        } else {
+            provider = std::make_shared<yfinance_provider>();
+        }
+    }
 
-    if (!file.is_open() || !file.good()){
-        LOG_F(INFO, "Impossible to load Share Price Cache");
-        return;
+    return provider;
+}
+
+quotes_map get_quotes(const std::string& ticker, budget::date start_date, budget::date end_date) {
+    quotes_map quotes;
+
+    for (auto& [d, price] : get_provider()->quotes(ticker, start_date, end_date)) {
+        quotes.emplace(share_price_cache_key(d, ticker), price);
     }
 
+    return quotes;
+}
+
+std::string cache_path() {
+    return budget::path_to_budget_file("share_price.cache");
+}
+
+bool is_binary_format() {
+    return budget::config_value("data_format", "text") == "binary";
+}
+
+void read_text_cache(std::ifstream& file) {
     std::string line;
     while (file.good() && getline(file, line)) {
         if (line.empty()) {
@@ -152,7 +200,7 @@ void budget::load_share_price_cache(){
         std::string  ticker;
         double       value;
 
-        data_reader reader;
+        budget::data_reader reader;
         reader.parse(line);
 
         reader >> day;
@@ -162,122 +210,328 @@ void budget::load_share_price_cache(){
         share_price_cache_key key(day, ticker);
         share_prices[key] = budget::money::from_double(value);
     }
+}
+
+void read_binary_cache(const std::string& file_path) {
+    cache_file = std::make_unique<budget::price_cache_file>(file_path);
+
+    std::vector<budget::price_record> records;
+    cache_file->load(records);
+
+    for (auto& record : records) {
+        budget::money price;
+        price.value = record.value;
+
+        share_price_cache_key key(budget::date::from_day_number(record.day), cache_file->key(record.key));
+        share_prices[key] = price;
+    }
+}
+
+void read_cache() {
+    auto file_path = cache_path();
+
+    budget::server_lock_guard l(shares_lock);
+
+    if (budget::is_price_cache_file(file_path)) {
+        read_binary_cache(file_path);
+    } else {
+        std::ifstream file(file_path);
+
+        if (!file.is_open() || !file.good()){
+            LOG_F(INFO, "Impossible to load Share Price Cache");
+            return;
+        }
+
+        read_text_cache(file);
+    }
 
     LOG_F(INFO, "Share Price Cache has been loaded from {}", file_path);
     LOG_F(INFO, "Share Price Cache has {} entries", share_prices.size());
 }
 
+size_t cached_prices() {
+    budget::server_shared_lock_guard l(shares_lock);
+    return share_prices.size();
+}
+
+void ensure_cache_loaded() {
+    if (cache_requested) {
+        std::call_once(cache_loaded, read_cache);
+    }
+}
+
+// Append the given prices to the current cache file
+bool append_prices(const std::string& file_path, const std::vector<std::pair<share_price_cache_key, budget::money>>& prices) {
+    if (is_binary_format()) {
+        std::vector<budget::price_record> records;
+
+        for (auto& [key, value] : prices) {
+            if (value != budget::money(1)) {
+                records.push_back({cache_file->key_id(key.ticker), key.date.day_number(), value.value});
+            }
+        }
+
+        return cache_file->append(records);
+    }
+
+    std::ofstream file(file_path, std::ios::app);
+
+    for (auto& [key, value] : prices) {
+        if (value == budget::money(1)) {
+            continue;
+        }
+
+        budget::data_writer writer;
+        writer << key.date;
+        writer << key.ticker;
+        writer << value;
+        file << writer.to_string() << std::endl;
+    }
+
+    return file.good();
+}
+
+// Store the fetched quotes in the cache, shares_lock must be held
+void store_quotes(const quotes_map& quotes) {
+    for (auto& [key, value] : quotes) {
+        auto [it, inserted] = share_prices.emplace(key, value);
+
+        // Only the new prices need to be written to the cache file
+        if (inserted || it->second != value) {
+            it->second = value;
+            pending.emplace_back(key, value);
+        }
+    }
+}
+
+// Find the price of key once the quotes around d have been stored,
+// shares_lock must be held
+budget::money resolve_price(const share_price_cache_key& key, budget::date d, bool found) {
+    auto date = key.date;
+
+    // If the API did not find anything, it must mean that the ticker is
+    // invalid
+    if (!found) {
+        LOG_F(INFO,
+              "Price: Could not find quotes for {} for date {} ({}-{})",
+              key.ticker,
+              budget::to_string(d),
+              budget::to_string(d - budget::days(fetch_days)),
+              budget::to_string(d + budget::days(fetch_days)));
+
+        share_prices[key] = budget::money(1);
+        return budget::money(1);
+    }
+
+    // If it has not been found, it may be a holiday, so we try to get
+    // back in time to find a proper value
+    if (!share_prices.count(key)) {
+        for (size_t i = 0; i < 4; ++i){
+            auto next_date = get_valid_date(date - budget::days(1));
+
+            LOG_F(INFO, "Price: Possible holiday on {}, retrying on {}", budget::to_string(date), budget::to_string(next_date));
+
+            share_price_cache_key next_key(next_date, key.ticker);
+            if (share_prices.count(next_key)) {
+                share_prices[key] = share_prices[next_key];
+                pending.emplace_back(key, share_prices[key]);
+                break;
+            }
+        }
+    }
+
+    cpp_assert(share_prices.count(key), "Invalid state in share_price");
+
+    LOG_F(INFO, "Price: Share price ({}) ticker {} = {}", budget::to_string(date), key.ticker, budget::to_string(share_prices[key]));
+
+    return share_prices[key];
+}
+
+} // end of anonymous namespace
+
+void budget::set_share_price_provider(std::shared_ptr<share_price_provider> new_provider){
+    std::lock_guard<std::mutex> l(provider_lock);
+    provider = std::move(new_provider);
+}
+
+void budget::load_share_price_cache(){
+    cache_requested = true;
+}
+
 void budget::save_share_price_cache() {
-    std::string file_path = budget::path_to_budget_file("share_price.cache");
-    std::ofstream file(file_path);
+    // Nothing to write if no price has been fetched
+    {
+        server_shared_lock_guard l(shares_lock);
 
-    if (!file.is_open() || !file.good()){
-        LOG_F(INFO, "Impossible to save Share Price Cache");
+        if (pending.empty()) {
+            return;
+        }
+    }
+
+    auto file_path = cache_path();
+
+    // The current content of the file must be known before writing to it,
+    // even if the cache has never been used
+    std::call_once(cache_loaded, read_cache);
+
+    // The file is written under the lock, two saves must not write it at
+    // the same time
+    server_lock_guard l(shares_lock);
+
+    auto prices = std::move(pending);
+    pending.clear();
+
+    if (prices.empty()) {
         return;
     }
 
-    {
-        server_lock_guard l(shares_lock);
+    // If the file is not in the current format, it is rewritten with all the prices
+    if (is_binary_format() != bool(cache_file)) {
+        if (is_binary_format()) {
+            cache_file = std::make_unique<price_cache_file>(file_path);
+        } else {
+            cache_file.reset();
+            std::ofstream file(file_path, std::ios::trunc);
+        }
+
+        std::vector<std::pair<share_price_cache_key, budget::money>> all;
 
         for (auto& [key, value] : share_prices) {
             if (value != budget::money(1)) {
-                data_writer writer;
-                writer << key.date;
-                writer << key.ticker;
-                writer << value;
-                file << writer.to_string() << std::endl;
+                all.emplace_back(key, value);
             }
         }
+
+        // The new prices are written last so that they win over the old ones
+        all.insert(all.end(), prices.begin(), prices.end());
+        prices = std::move(all);
+    }
+
+    if (!append_prices(file_path, prices)) {
+        LOG_F(INFO, "Impossible to save Share Price Cache");
+        return;
     }
 
     LOG_F(INFO, "Share Price Cache has been saved to {}", file_path);
-    LOG_F(INFO, "Share Price Cache has {} entries", share_prices.size());
+    LOG_F(INFO, "Share Price Cache has {} new entries", prices.size());
 }
 
 void budget::prefetch_share_price_cache(){
-    std::set<std::string> tickers;
+    ensure_cache_loaded();
+
+    std::vector<std::pair<std::string, budget::date>> prices;
 
     {
-        server_lock_guard l(shares_lock);
+        server_shared_lock_guard l(shares_lock);
 
         // Collect all the tickers
+        std::set<std::string> tickers;
+
         for (auto& [key, value] : share_prices) {
             tickers.insert(key.ticker);
         }
+
+        for (auto& ticker : tickers) {
+            prices.emplace_back(ticker, budget::local_day());
+        }
     }
 
     // Prefetch the current prices
-    for (auto & ticker : tickers) {
-        share_price(ticker);
-    }
+    prefetch_share_prices(prices);
 
     LOG_F(INFO, "Share Price Cache has been prefetched");
-    LOG_F(INFO, "Share Price Cache has {} entries", share_prices.size());
+    LOG_F(INFO, "Share Price Cache has {} entries", cached_prices());
 }
 
-budget::money budget::share_price(const std::string& ticker){
-    return share_price(ticker, budget::local_day());
-}
+void budget::prefetch_share_prices(const std::vector<std::pair<std::string, budget::date>>& prices){
+    ensure_cache_loaded();
 
-budget::money budget::share_price(const std::string& ticker, budget::date d){
-    auto date = get_valid_date(d);
+    struct fetch_window {
+        std::string ticker;
+        budget::date date;
+        std::vector<share_price_cache_key> keys;
+        quotes_map quotes;
+    };
 
-    share_price_cache_key key(date, ticker);
+    std::vector<share_price_cache_key> keys;
 
     {
-        server_lock_guard l(shares_lock);
+        server_shared_lock_guard l(shares_lock);
 
-        if (share_prices.count(key)) {
-            return share_prices[key];
+        for (auto& [ticker, d] : prices) {
+            share_price_cache_key key(get_valid_date(d), ticker);
+
+            if (!share_prices.count(key)) {
+                keys.push_back(key);
+            }
         }
     }
 
-    // Note: we use a range for two reasons
-    // 1) Handle potential holidays, so we have a range in the past
-    // 2) Opportunistically grab several quotes in the past and future to save on API calls
-    auto start_date = d - budget::days(10);
-    auto end_date   = d + budget::days(10);
-    auto quotes     = get_share_price_v3(ticker, start_date, end_date);
+    std::sort(keys.begin(), keys.end(), [](auto& lhs, auto& rhs) { return std::tie(lhs.ticker, lhs.date) < std::tie(rhs.ticker, rhs.date); });
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
 
-    server_lock_guard l(shares_lock);
+    // A single fetch covers all the dates of a ticker within its window
+    std::vector<fetch_window> windows;
 
-    // If the API did not find anything, it must mean that the ticker is
-    // invalid
-    if (quotes.empty()) {
-        LOG_F(INFO,
-              "Price: Could not find quotes for {} for date {} ({}-{})",
-              ticker,
-              budget::to_string(d),
-              budget::to_string(start_date),
-              budget::to_string(end_date));
+    for (auto& key : keys) {
+        if (windows.empty() || windows.back().ticker != key.ticker || key.date > windows.back().date + budget::days(fetch_days)) {
+            windows.push_back({key.ticker, key.date, {}, {}});
+        }
 
-        share_prices[key] = money(1);
-        return money(1);
+        windows.back().keys.push_back(key);
     }
 
-    for (auto [new_key, new_value] : quotes) {
-        share_prices[new_key] = new_value;
+    if (windows.empty()) {
+        return;
     }
 
-    // If it has not been found, it may be a holiday, so we try to get
-    // back in time to find a proper value
-    if (!share_prices.count(key)) {
-        for (size_t i = 0; i < 4; ++i){
-            auto next_date = get_valid_date(date - budget::days(1));
+    parallel_for(windows.size(), get_fetch_concurrency(), [&windows](size_t i) {
+        auto& window  = windows[i];
+        window.quotes = get_quotes(window.ticker, window.date - budget::days(fetch_days), window.date + budget::days(fetch_days));
+    });
 
-            LOG_F(INFO, "Price: Possible holiday on {}, retrying on {}", budget::to_string(date), budget::to_string(next_date));
+    server_lock_guard l(shares_lock);
 
-            share_price_cache_key next_key(next_date, ticker);
-            if (share_prices.count(next_key)) {
-                share_prices[key] = share_prices[next_key];
-                break;
-            }
+    for (auto& window : windows) {
+        store_quotes(window.quotes);
+    }
+
+    for (auto& window : windows) {
+        for (auto& key : window.keys) {
+            resolve_price(key, window.date, !window.quotes.empty());
         }
     }
 
-    cpp_assert(share_prices.count(key), "Invalid state in share_price");
+    LOG_F(INFO, "Price: Prefetched {} share prices with {} fetches", keys.size(), windows.size());
+}
 
-    LOG_F(INFO, "Price: Share price ({}) ticker {} = {}", budget::to_string(date), ticker, budget::to_string(share_prices[key]));
+budget::money budget::share_price(const std::string& ticker){
+    return share_price(ticker, budget::local_day());
+}
 
-    return share_prices[key];
+budget::money budget::share_price(const std::string& ticker, budget::date d){
+    ensure_cache_loaded();
+
+    auto date = get_valid_date(d);
+
+    share_price_cache_key key(date, ticker);
+
+    {
+        server_shared_lock_guard l(shares_lock);
+
+        if (auto it = share_prices.find(key); it != share_prices.end()) {
+            return it->second;
+        }
+    }
+
+    // Note: we use a range for two reasons
+    // 1) Handle potential holidays, so we have a range in the past
+    // 2) Opportunistically grab several quotes in the past and future to save on API calls
+    auto quotes = get_quotes(ticker, d - budget::days(fetch_days), d + budget::days(fetch_days));
+
+    server_lock_guard l(shares_lock);
+
+    store_quotes(quotes);
+
+    return resolve_price(key, d, !quotes.empty());
 }
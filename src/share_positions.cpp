@@ -0,0 +1,113 @@
+//=======================================================================
+// Copyright (c) 2013-2020 Baptiste Wicht.
+// Distributed under the terms of the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+#include <algorithm>
+
+#include "share_positions.hpp"
+#include "share.hpp"
+
+using namespace budget;
+
+budget::share_positions::share_positions(const std::vector<asset_share>& asset_shares) {
+    std::unordered_map<size_t, std::vector<const asset_share*>> groups;
+
+    for (auto& share : asset_shares) {
+        groups[share.asset_id].push_back(&share);
+    }
+
+    for (auto& [asset_id, shares] : groups) {
+        std::stable_sort(shares.begin(), shares.end(), [](auto* lhs, auto* rhs) { return lhs->date < rhs->date; });
+
+        auto& positions = assets[asset_id];
+
+        share_position current{shares.front()->date, 0, {}, {}};
+
+        for (auto* share : shares) {
+            // Only keep the last position of each date
+            if (share->date != current.date) {
+                positions.push_back(current);
+                current.date = share->date;
+            }
+
+            if (share->is_buy()) {
+                current.cost += static_cast<int>(share->shares) * share->price;
+            } else {
+                auto sold = -share->shares;
+
+                // The average cost of the sold shares
+                budget::money cost;
+
+                if (current.shares > 0) {
+                    cost.value = current.cost.value * std::min(sold, current.shares) / current.shares;
+                }
+
+                current.cost -= cost;
+                current.realized += static_cast<int>(sold) * share->price - cost;
+            }
+
+            current.shares += share->shares;
+        }
+
+        positions.push_back(current);
+    }
+}
+
+const share_position* budget::share_positions::at(size_t asset_id, budget::date d) const {
+    auto& values = positions(asset_id);
+
+    auto it = std::upper_bound(values.begin(), values.end(), d, [](budget::date d, auto& position) { return d < position.date; });
+
+    if (it == values.begin()) {
+        return nullptr;
+    }
+
+    return &*std::prev(it);
+}
+
+const std::vector<share_position>& budget::share_positions::positions(size_t asset_id) const {
+    static const std::vector<share_position> no_positions;
+
+    if (auto it = assets.find(asset_id); it != assets.end()) {
+        return it->second;
+    }
+
+    return no_positions;
+}
+
+int64_t budget::share_positions::shares(size_t asset_id, budget::date d) const {
+    auto* position = at(asset_id, d);
+    return position ? position->shares : 0;
+}
+
+budget::money budget::share_positions::cost_basis(size_t asset_id, budget::date d) const {
+    auto* position = at(asset_id, d);
+    return position ? position->cost : budget::money();
+}
+
+budget::money budget::share_positions::realized_gain(size_t asset_id, budget::date d) const {
+    auto* position = at(asset_id, d);
+    return position ? position->realized : budget::money();
+}
+
+budget::money budget::share_positions::unrealized_gain(size_t asset_id, budget::date d, budget::money price) const {
+    auto* position = at(asset_id, d);
+
+    if (!position || position->shares <= 0) {
+        return {};
+    }
+
+    return static_cast<int>(position->shares) * price - position->cost;
+}
+
+budget::money budget::share_positions::unrealized_gain(size_t asset_id, budget::date d) const {
+    // No need to fetch a price without shares
+    if (shares(asset_id, d) <= 0) {
+        return {};
+    }
+
+    return unrealized_gain(asset_id, d, share_price(get_asset(asset_id)->ticker, d));
+}
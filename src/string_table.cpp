@@ -0,0 +1,65 @@
+//=======================================================================
+// Copyright (c) 2013-2020 Baptiste Wicht.
+// Distributed under the terms of the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+#include <algorithm>
+#include <cctype>
+#include <mutex>
+
+#include "string_table.hpp"
+
+using namespace budget;
+
+string_id budget::string_table::intern(std::string_view value) {
+    {
+        std::shared_lock<std::shared_mutex> l(lock);
+
+        if (auto it = ids.find(value); it != ids.end()) {
+            return it->second;
+        }
+    }
+
+    std::unique_lock<std::shared_mutex> l(lock);
+    return insert(value);
+}
+
+// Must be called with the lock held exclusively
+string_id budget::string_table::insert(std::string_view value) {
+    if (auto it = ids.find(value); it != ids.end()) {
+        return it->second;
+    }
+
+    std::string lower(value);
+    std::transform(lower.begin(), lower.end(), lower.begin(), [](unsigned char c) { return std::tolower(c); });
+
+    string_id folded = lower == value ? static_cast<string_id>(entries.size()) : insert(lower);
+    string_id id     = static_cast<string_id>(entries.size());
+
+    entries.push_back({std::string(value), folded});
+    ids.emplace(entries.back().value, id);
+
+    return id;
+}
+
+const std::string& budget::string_table::str(string_id id) const {
+    std::shared_lock<std::shared_mutex> l(lock);
+    return entries[id].value;
+}
+
+string_id budget::string_table::folded(string_id id) const {
+    std::shared_lock<std::shared_mutex> l(lock);
+    return entries[id].folded;
+}
+
+size_t budget::string_table::size() const {
+    std::shared_lock<std::shared_mutex> l(lock);
+    return entries.size();
+}
+
+string_table& budget::names() {
+    static string_table table;
+    return table;
+}
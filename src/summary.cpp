@@ -147,14 +147,6 @@ void month_overview() {
 
 constexpr const std::array<std::pair<const char*, const char*>, 1> budget::module_traits<budget::summary_module>::aliases;
 
-void budget::summary_module::load() {
-    load_accounts();
-    load_expenses();
-    load_earnings();
-    load_objectives();
-    load_fortunes();
-}
-
 void budget::summary_module::handle(std::vector<std::string>& args) {
     if (no_accounts()) {
         throw budget_exception("No accounts defined, you should start by defining some of them");
@@ -235,8 +227,8 @@ void budget::account_summary(budget::writer& w, budget::month month, budget::yea
         budget::month m = i;
 
         for (auto& account : all_accounts(w.cache, year, m)) {
-            auto total_expenses = accumulate_amount_if(w.cache.expenses(), [account, year, m](const budget::expense& e) { return e.account == account.id && e.date.year() == year && e.date.month() == m; });
-            auto total_earnings = accumulate_amount_if(w.cache.earnings(), [account, year, m](const budget::earning& e) { return e.account == account.id && e.date.year() == year && e.date.month() == m; });
+            auto total_expenses = w.cache.totals().account_expenses(account.id, year, m);
+            auto total_earnings = w.cache.totals().account_earnings(account.id, year, m);
 
             auto balance       = account_previous[account.name] + account.amount - total_expenses + total_earnings;
             auto local_balance = account.amount - total_expenses + total_earnings;
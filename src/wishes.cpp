@@ -101,20 +101,6 @@ std::map<std::string, std::string> budget::wish::get_params() const {
     return params;
 }
 
-void budget::wishes_module::load(){
-    load_expenses();
-    load_earnings();
-    load_accounts();
-
-    // Need to load both to make sure to have the correct information
-    load_assets();
-    load_fortunes();
-
-    // Need to be loaded last
-    load_objectives();
-    load_wishes();
-}
-
 void budget::wishes_module::unload(){
     save_wishes();
 }
@@ -159,7 +145,7 @@ void budget::wishes_module::handle(const std::vector<std::string>& args){
 
             size_t id = to_number<size_t>(args[2]);
 
-            auto wish = wishes[id];
+            budget::wish wish = wishes[id];
 
             edit(wish);
 
@@ -171,7 +157,7 @@ void budget::wishes_module::handle(const std::vector<std::string>& args){
 
             size_t id = to_number<size_t>(args[2]);
 
-            auto wish = wishes[id];
+            budget::wish wish = wishes[id];
 
             edit_money(wish.paid_amount, "Paid Amount", not_negative_checker(), not_zero_checker());
 
@@ -223,7 +209,7 @@ void budget::wish::load(data_reader & reader){
     }
 }
 
-std::vector<wish> budget::all_wishes(){
+data_snapshot<wish> budget::all_wishes(){
     return wishes.data();
 }
 
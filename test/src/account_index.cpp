@@ -0,0 +1,80 @@
+//=======================================================================
+// Copyright (c) 2013-2020 Baptiste Wicht
+// Distributed under the terms of the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+#include "test.hpp"
+#include "account_index.hpp"
+
+namespace {
+
+budget::account make_account(size_t id, const std::string& name, budget::date since, budget::date until) {
+    budget::account account;
+    account.id    = id;
+    account.name  = name;
+    account.since = since;
+    account.until = until;
+    return account;
+}
+
+// Food has two versions, Car is archived in 2019-06 and Bike starts in 2019-03
+budget::account_index make_index() {
+    std::vector<budget::account> accounts{
+        make_account(1, "Food", budget::date(2018, 1, 1), budget::date(2019, 5, 1)),
+        make_account(2, "Car", budget::date(2018, 1, 1), budget::date(2019, 6, 1)),
+        make_account(3, "Food", budget::date(2019, 5, 1), budget::date(2099, 12, 31)),
+        make_account(4, "Bike", budget::date(2019, 3, 1), budget::date(2099, 12, 31)),
+    };
+
+    return budget::account_index(accounts);
+}
+
+std::vector<size_t> ids(budget::span<budget::account> accounts) {
+    std::vector<size_t> ids;
+
+    for (auto& account : accounts) {
+        ids.push_back(account.id);
+    }
+
+    return ids;
+}
+
+} // end of anonymous namespace
+
+TEST_CASE("account_index/active") {
+    auto index = make_index();
+
+    FAST_CHECK_UNARY(index.active(budget::date(2017, 5, 5)).empty());
+    FAST_CHECK_UNARY((ids(index.active(budget::date(2018, 5, 5))) == std::vector<size_t>{1, 2}));
+    FAST_CHECK_UNARY((ids(index.active(budget::date(2019, 3, 5))) == std::vector<size_t>{1, 2, 4}));
+    FAST_CHECK_UNARY((ids(index.active(budget::date(2019, 5, 5))) == std::vector<size_t>{2, 3, 4}));
+    FAST_CHECK_UNARY((ids(index.active(budget::date(2019, 7, 5))) == std::vector<size_t>{3, 4}));
+    FAST_CHECK_UNARY(index.active(budget::date(2100, 1, 5)).empty());
+
+    // The bounds themselves are excluded
+    FAST_CHECK_UNARY((ids(index.active(budget::date(2019, 5, 1))) == std::vector<size_t>{2, 4}));
+    FAST_CHECK_UNARY((ids(index.active(budget::date(2019, 3, 1))) == std::vector<size_t>{1, 2}));
+}
+
+TEST_CASE("account_index/find") {
+    auto index = make_index();
+
+    REQUIRE(index.find("Food", budget::date(2019, 4, 5)));
+    FAST_CHECK_EQ(index.find("Food", budget::date(2019, 4, 5))->id, 1);
+
+    REQUIRE(index.find("Food", budget::date(2019, 5, 5)));
+    FAST_CHECK_EQ(index.find("Food", budget::date(2019, 5, 5))->id, 3);
+
+    FAST_CHECK_UNARY(!index.find("Car", budget::date(2019, 7, 5)));
+    FAST_CHECK_UNARY(!index.find("Bike", budget::date(2019, 2, 5)));
+    FAST_CHECK_UNARY(!index.find("Boat", budget::date(2019, 5, 5)));
+}
+
+TEST_CASE("account_index/empty") {
+    budget::account_index index(std::vector<budget::account>{});
+
+    FAST_CHECK_UNARY(index.active(budget::date(2019, 5, 5)).empty());
+    FAST_CHECK_UNARY(!index.find("Food", budget::date(2019, 5, 5)));
+}
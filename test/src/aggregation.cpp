@@ -0,0 +1,94 @@
+//=======================================================================
+// Copyright (c) 2013-2020 Baptiste Wicht
+// Distributed under the terms of the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+#include <random>
+
+#include "test.hpp"
+#include "aggregation.hpp"
+
+namespace {
+
+struct columns {
+    std::vector<uint32_t> days;
+    std::vector<uint32_t> accounts;
+    std::vector<int64_t> amounts;
+};
+
+// Odd size so that the kernels also have to handle a tail
+columns random_columns(size_t n = 1003) {
+    std::mt19937_64 generator(42);
+    std::uniform_int_distribution<uint32_t> day_distribution(730000, 740000);
+    std::uniform_int_distribution<uint32_t> account_distribution(1, 5);
+    std::uniform_int_distribution<int64_t> amount_distribution(-100000, 100000);
+
+    columns c;
+
+    for (size_t i = 0; i < n; ++i) {
+        c.days.push_back(day_distribution(generator));
+        c.accounts.push_back(account_distribution(generator));
+        c.amounts.push_back(amount_distribution(generator));
+    }
+
+    return c;
+}
+
+int64_t reference_sum(const columns& c, size_t n, uint32_t first_day, uint32_t last_day, uint32_t account) {
+    int64_t total = 0;
+
+    for (size_t i = 0; i < n; ++i) {
+        if (c.days[i] >= first_day && c.days[i] <= last_day && (account == budget::any_account || c.accounts[i] == account)) {
+            total += c.amounts[i];
+        }
+    }
+
+    return total;
+}
+
+} // end of anonymous namespace
+
+TEST_CASE("aggregation/masked_sum") {
+    auto c = random_columns();
+
+    for (size_t n : {0, 1, 3, 4, 7, 8, 9, 17, 1003}) {
+        for (uint32_t account : {1U, 3U, 6U, budget::any_account}) {
+            FAST_CHECK_EQ(budget::masked_sum(c.accounts.data(), c.amounts.data(), n, account), reference_sum(c, n, 0, 0xFFFFFFFF, account));
+            FAST_CHECK_EQ(budget::masked_sum(c.days.data(), c.accounts.data(), c.amounts.data(), n, 732000, 736000, account),
+                          reference_sum(c, n, 732000, 736000, account));
+        }
+
+        FAST_CHECK_EQ(budget::sum_amounts(c.amounts.data(), n), reference_sum(c, n, 0, 0xFFFFFFFF, budget::any_account));
+    }
+}
+
+TEST_CASE("aggregation/histogram") {
+    std::vector<uint32_t> days{5, 10, 12, 20, 25, 31, 40};
+    std::vector<uint32_t> accounts{1, 2, 1, 1, 4, 2, 1};
+    std::vector<int64_t> amounts{100, 1, 2, 3, 4, 5, 1000};
+
+    // Three months: [10, 20), [20, 30), [30, 40)
+    std::vector<uint32_t> month_starts{10, 20, 30, 40};
+
+    // The account 4 has no row
+    std::vector<uint32_t> account_rows{budget::any_account, 0, 1};
+
+    std::vector<int64_t> buckets(2 * 3, 0);
+
+    budget::histogram(days.data(), accounts.data(), amounts.data(), days.size(), month_starts, account_rows, buckets.data());
+
+    FAST_CHECK_EQ(buckets[0], 2);
+    FAST_CHECK_EQ(buckets[1], 3);
+    FAST_CHECK_EQ(buckets[2], 0);
+    FAST_CHECK_EQ(buckets[3], 1);
+    FAST_CHECK_EQ(buckets[4], 0);
+    FAST_CHECK_EQ(buckets[5], 5);
+}
+
+TEST_CASE("aggregation/kernels") {
+    std::string kernels = budget::aggregation_kernels();
+
+    FAST_CHECK_UNARY(kernels == "avx2" || kernels == "sse2" || kernels == "scalar");
+}
@@ -0,0 +1,138 @@
+//=======================================================================
+// Copyright (c) 2013-2020 Baptiste Wicht
+// Distributed under the terms of the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+
+#include "test.hpp"
+#include "columnar.hpp"
+#include "data.hpp"
+#include "date.hpp"
+#include "money.hpp"
+
+using namespace std::string_literals;
+
+TEST_CASE("columnar/round_trip") {
+    const std::string path = "columnar_test.data";
+
+    std::vector<budget::data_writer> records(3);
+
+    for (size_t i = 0; i < records.size(); ++i) {
+        records[i] << size_t(i + 1);
+        records[i] << "name:"s + std::to_string(i);
+        records[i] << budget::date(2020, 2, 10 + i);
+        records[i] << budget::money(100 + i, 55);
+        records[i] << bool(i % 2);
+        records[i] << int32_t(-1 - int32_t(i));
+    }
+
+    REQUIRE(budget::write_columnar_file(path, 4, records));
+    REQUIRE(budget::is_columnar_file(path));
+
+    budget::columnar_file file(path);
+
+    REQUIRE(file.valid());
+    FAST_CHECK_EQ(file.next_id(), 4);
+    FAST_CHECK_EQ(file.rows(), 3);
+    FAST_CHECK_EQ(file.columns(), 6);
+
+    budget::data_reader reader;
+
+    for (size_t i = 0; i < file.rows(); ++i) {
+        reader.parse(file, i);
+
+        size_t id;
+        std::string name;
+        budget::date date;
+        budget::money amount;
+        bool flag;
+        int32_t value;
+
+        reader >> id >> name >> date >> amount >> flag >> value;
+
+        FAST_CHECK_EQ(id, i + 1);
+        FAST_CHECK_EQ(name, "name:"s + std::to_string(i));
+        FAST_CHECK_EQ(date, budget::date(2020, 2, 10 + i));
+        FAST_CHECK_EQ(amount, budget::money(100 + i, 55));
+        FAST_CHECK_EQ(flag, bool(i % 2));
+        FAST_CHECK_EQ(value, -1 - int32_t(i));
+        FAST_CHECK_UNARY(!reader.more());
+    }
+
+    // A string can be read from any column
+    reader.parse(file, 0);
+    FAST_CHECK_EQ(reader.peek(), "1");
+    reader.skip();
+    reader.skip();
+    FAST_CHECK_EQ(reader.peek(), "2020-02-10");
+
+    std::remove(path.c_str());
+}
+
+TEST_CASE("columnar/schema") {
+    std::vector<budget::data_writer> records(2);
+
+    records[0] << size_t(1) << "a"s;
+    records[1] << size_t(2) << budget::money(1);
+
+    FAST_CHECK_UNARY(!budget::write_columnar_file("columnar_schema.data", 3, records));
+    FAST_CHECK_UNARY(!budget::is_columnar_file("columnar_schema.data"));
+}
+
+TEST_CASE("columnar/corrupted") {
+    const std::string path = "columnar_corrupted.data";
+
+    std::vector<budget::data_writer> records(2);
+
+    records[0] << size_t(1) << "a"s;
+    records[1] << size_t(2) << "bc"s;
+
+    REQUIRE(budget::write_columnar_file(path, 3, records));
+
+    std::string content;
+
+    {
+        std::ifstream file(path, std::ios::binary);
+        content.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+
+    auto corrupt = [&](size_t offset, uint64_t value) {
+        auto copy = content;
+        std::memcpy(&copy[offset], &value, sizeof(value));
+
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file.write(copy.data(), copy.size());
+    };
+
+    // The header is 32 bytes, each column entry is type, offset and size
+    const size_t first_column  = 32;
+    const size_t second_column = 32 + 24;
+
+    corrupt(first_column, 42);
+    REQUIRE_THROWS_AS(budget::columnar_file(path), budget::budget_exception);
+
+    corrupt(first_column + 16, 8);
+    REQUIRE_THROWS_AS(budget::columnar_file(path), budget::budget_exception);
+
+    corrupt(second_column + 8, uint64_t(-8));
+    REQUIRE_THROWS_AS(budget::columnar_file(path), budget::budget_exception);
+
+    // The second offset of the strings points past the heap
+    uint64_t strings_offset;
+    std::memcpy(&strings_offset, &content[second_column + 8], sizeof(strings_offset));
+
+    corrupt(strings_offset + 8, 1000);
+    REQUIRE_THROWS_AS(budget::columnar_file(path), budget::budget_exception);
+
+    // The file itself is still valid
+    corrupt(0, *reinterpret_cast<const uint64_t*>(content.data()));
+    FAST_CHECK_UNARY(budget::columnar_file(path).valid());
+
+    std::remove(path.c_str());
+}
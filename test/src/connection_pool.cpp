@@ -0,0 +1,101 @@
+//=======================================================================
+// Copyright (c) 2013-2020 Baptiste Wicht
+// Distributed under the terms of the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "test.hpp"
+#include "connection_pool.hpp"
+
+namespace {
+
+struct fake_client {
+    std::string host;
+    size_t port;
+    bool keep_alive = false;
+
+    fake_client(const char* host, size_t port) : host(host), port(port) {}
+
+    void set_keep_alive(bool value) {
+        keep_alive = value;
+    }
+};
+
+} // end of anonymous namespace
+
+TEST_CASE("connection_pool/reuse") {
+    budget::connection_pool<fake_client> pool("localhost", 8080);
+
+    fake_client* first = nullptr;
+
+    {
+        auto cli = pool.acquire();
+        FAST_CHECK_UNARY(!cli.was_reused());
+        FAST_CHECK_UNARY(cli->keep_alive);
+        FAST_CHECK_EQ(cli->host, "localhost");
+        FAST_CHECK_EQ(cli->port, 8080);
+        first = &*cli;
+    }
+
+    {
+        auto cli = pool.acquire();
+        FAST_CHECK_UNARY(cli.was_reused());
+        FAST_CHECK_EQ(&*cli, first);
+
+        // Used at the same time, another connection is needed
+        auto other = pool.acquire();
+        FAST_CHECK_UNARY(!other.was_reused());
+        FAST_CHECK_NE(&*other, first);
+    }
+
+    FAST_CHECK_EQ(pool.connections(), 2);
+}
+
+TEST_CASE("connection_pool/discard") {
+    budget::connection_pool<fake_client> pool("localhost", 8080);
+
+    {
+        auto cli = pool.acquire();
+        cli.discard();
+    }
+
+    FAST_CHECK_UNARY(!pool.acquire().was_reused());
+    FAST_CHECK_EQ(pool.connections(), 2);
+}
+
+TEST_CASE("connection_pool/timeout") {
+    budget::connection_pool<fake_client> pool("localhost", 8080, 8, std::chrono::milliseconds(0));
+
+    pool.acquire();
+
+    // The idle connection has expired
+    FAST_CHECK_UNARY(!pool.acquire().was_reused());
+}
+
+TEST_CASE("connection_pool/concurrent") {
+    budget::connection_pool<fake_client> pool("localhost", 8080, 4);
+
+    std::vector<std::thread> threads;
+
+    for (size_t t = 0; t < 4; ++t) {
+        threads.emplace_back([&pool]() {
+            for (size_t i = 0; i < 1000; ++i) {
+                auto cli = pool.acquire();
+                cli->port = 8080;
+            }
+        });
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    // Never more connections than concurrent users
+    FAST_CHECK_UNARY(pool.connections() <= 4);
+}
@@ -0,0 +1,93 @@
+//=======================================================================
+// Copyright (c) 2013-2020 Baptiste Wicht
+// Distributed under the terms of the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+#include <atomic>
+#include <string>
+#include <thread>
+
+#include "test.hpp"
+#include "currency.hpp"
+#include "date.hpp"
+#include "http.hpp"
+
+namespace {
+
+// A stand-in for the exchange rates server, serving canned rates, the
+// previous server is restored once done
+struct rates_server {
+    httplib::Server server;
+    std::thread thread;
+    std::atomic<size_t> requests{0};
+    budget::exchange_rates_server previous = budget::get_exchange_rates_server();
+
+    rates_server() {
+        server.Get("/history", [this](const httplib::Request& req, httplib::Response& res) {
+            ++requests;
+
+            if (req.get_param_value("base") != "USD" || req.get_param_value("symbols") != "JPY") {
+                res.status = 404;
+                return;
+            }
+
+            // 2020-01-04 and 2020-01-05 are a week-end
+            res.set_content(R"({"rates":{"2020-01-03":{"JPY":108.0},"2020-01-02":{"JPY":100.0},"2020-01-06":{"JPY":125.0}},"start_at":"2019-12-26","base":"USD","end_at":"2020-01-06"})",
+                            "application/json");
+        });
+
+        int port = server.bind_to_any_port("localhost");
+        budget::set_exchange_rates_server("localhost", port, false);
+
+        thread = std::thread([this]() { server.listen_after_bind(); });
+    }
+
+    ~rates_server() {
+        server.stop();
+        thread.join();
+
+        budget::set_exchange_rates_server(previous.host, previous.port, previous.ssl);
+    }
+};
+
+} // end of anonymous namespace
+
+TEST_CASE("currency/prefetch") {
+    rates_server server;
+
+    auto pair = budget::get_currency_pair("USD", "JPY");
+
+    budget::prefetch_exchange_rates({{pair, budget::date(2020, 1, 3)}, {pair, budget::date(2020, 1, 4)}, {pair, budget::date(2020, 1, 6)}});
+
+    FAST_CHECK_EQ(server.requests, 1);
+
+    FAST_CHECK_EQ(pair.rate(budget::date(2020, 1, 3)), 108.0);
+    FAST_CHECK_EQ(pair.rate(budget::date(2020, 1, 4)), 108.0);
+    FAST_CHECK_EQ(pair.rate(budget::date(2020, 1, 5)), 108.0);
+    FAST_CHECK_EQ(pair.rate(budget::date(2020, 1, 6)), 125.0);
+
+    // The reverse rates are filled by the same request
+    FAST_CHECK_EQ(budget::exchange_rate("JPY", "USD", budget::date(2020, 1, 6)), 1.0 / 125.0);
+
+    // Nothing is fetched again for cached rates
+    budget::prefetch_exchange_rates({{budget::get_currency_pair("JPY", "USD"), budget::date(2020, 1, 4)}});
+
+    FAST_CHECK_EQ(server.requests, 1);
+}
+
+TEST_CASE("currency/server") {
+    auto previous = budget::get_exchange_rates_server();
+
+    {
+        rates_server server;
+
+        FAST_CHECK_EQ(budget::get_exchange_rates_server().host, "localhost");
+    }
+
+    // The server used by the other tests is left untouched
+    FAST_CHECK_EQ(budget::get_exchange_rates_server().host, previous.host);
+    FAST_CHECK_EQ(budget::get_exchange_rates_server().port, previous.port);
+    FAST_CHECK_EQ(budget::get_exchange_rates_server().ssl, previous.ssl);
+}
@@ -0,0 +1,331 @@
+//=======================================================================
+// Copyright (c) 2013-2020 Baptiste Wicht
+// Distributed under the terms of the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "test.hpp"
+#include "config.hpp"
+#include "data.hpp"
+
+namespace fs = std::filesystem;
+
+namespace {
+
+struct record {
+    size_t id;
+    std::string guid;
+    std::string name;
+    int64_t value;
+
+    std::map<std::string, std::string> get_params() const {
+        return {};
+    }
+
+    void load(budget::data_reader& reader) {
+        reader >> id;
+        reader >> guid;
+        reader >> name;
+        reader >> value;
+    }
+
+    void save(budget::data_writer& writer) const {
+        writer << id;
+        writer << guid;
+        writer << name;
+        writer << value;
+    }
+
+    bool operator==(const record& rhs) const {
+        return id == rhs.id && guid == rhs.guid && name == rhs.name && value == rhs.value;
+    }
+};
+
+std::string record_line(size_t id, const std::string& name, int64_t value) {
+    return std::to_string(id) + ":guid-" + std::to_string(id) + ":" + name + ":" + std::to_string(value);
+}
+
+// Use a temporary data directory for the lifetime of the object
+struct temporary_directory {
+    fs::path path;
+    bool had_directory;
+    std::string previous;
+
+    temporary_directory() : path(fs::temp_directory_path() / "budget_test_data") {
+        fs::remove_all(path);
+        fs::create_directories(path);
+
+        had_directory = budget::config_contains("directory");
+        previous      = budget::config_value("directory", "");
+
+        budget::config_set("directory", path.string());
+    }
+
+    ~temporary_directory() {
+        if (had_directory) {
+            budget::config_set("directory", previous);
+        } else {
+            budget::config_remove("directory");
+        }
+
+        fs::remove_all(path);
+    }
+
+    std::string file(const std::string& name) const {
+        return (path / name).string();
+    }
+};
+
+void write_file(const std::string& path, const std::string& content) {
+    std::ofstream file(path, std::ios::trunc);
+    file << content;
+}
+
+std::string read_file(const std::string& path) {
+    std::ifstream file(path);
+    std::stringstream content;
+    content << file.rdbuf();
+    return content.str();
+}
+
+std::vector<record> load_records() {
+    budget::data_handler<record> handler("records", "records.data");
+    handler.load();
+    return handler.unsafe_data();
+}
+
+} // end of anonymous namespace
+
+TEST_CASE("data/parse_buffer/parallel") {
+    std::string content;
+
+    // Lines of different lengths, so that the chunk boundaries fall in
+    // the middle of lines, and some empty lines
+    for (size_t id = 1; content.size() < 2 * budget::parallel_parse_threshold; ++id) {
+        content += record_line(id, std::string(1 + (id * 37) % 200, 'a' + id % 26), int64_t(id) * 3 - 1000);
+        content += id % 1000 ? "\n" : "\n\n";
+    }
+
+    // No newline after the last record
+    content += record_line(999999, "last", 42);
+
+    auto load = [](budget::data_reader& reader, record& entry) { entry.load(reader); };
+
+    budget::data_handler<record> sequential("sequential", "sequential.data");
+    budget::data_handler<record> parallel("parallel", "parallel.data");
+
+    sequential.parse_buffer(content, load, false);
+
+    // The threads are forced so that the content is split even on a
+    // single core
+    parallel.parse_buffer(content, load, true, 4);
+
+    auto& expected = sequential.unsafe_data();
+    auto& result   = parallel.unsafe_data();
+
+    REQUIRE(expected.size() == result.size());
+    FAST_CHECK_UNARY(expected == result);
+    FAST_CHECK_EQ(expected.back().id, 999999);
+    FAST_CHECK_EQ(expected.back().name, "last");
+    FAST_CHECK_EQ(sequential.next_id, parallel.next_id);
+}
+
+TEST_CASE("data/journal/replay") {
+    temporary_directory directory;
+
+    write_file(directory.file("records.data"), "3\n1:guid-1:a:10\n2:guid-2:b:20\n");
+    write_file(directory.file("records.data.journal"), "A:3:guid-3:c:30\nE:1:guid-1:d:11\nR:2\n");
+
+    budget::data_handler<record> handler("records", "records.data");
+    handler.load();
+
+    auto& data = handler.unsafe_data();
+
+    REQUIRE(data.size() == 2);
+    FAST_CHECK_UNARY((data[0] == record{1, "guid-1", "d", 11}));
+    FAST_CHECK_UNARY((data[1] == record{3, "guid-3", "c", 30}));
+    FAST_CHECK_EQ(handler.next_id, 4);
+}
+
+TEST_CASE("data/journal/replay_twice") {
+    temporary_directory directory;
+
+    std::string journal = "A:3:guid-3:c:30\nE:1:guid-1:d:11\nR:2\n";
+
+    write_file(directory.file("records.data"), "3\n1:guid-1:a:10\n2:guid-2:b:20\n");
+    write_file(directory.file("records.data.journal"), journal);
+
+    auto first = load_records();
+
+    // Loading again replays the same journal on the same base
+    FAST_CHECK_UNARY(load_records() == first);
+
+    // A crash after the compaction but before the removal of the journal
+    // leaves a base file that already contains the mutations
+    write_file(directory.file("records.data"), "4\n1:guid-1:d:11\n3:guid-3:c:30\n");
+
+    FAST_CHECK_UNARY(load_records() == first);
+    FAST_CHECK_EQ(read_file(directory.file("records.data.journal")), journal);
+}
+
+TEST_CASE("data/journal/truncated") {
+    temporary_directory directory;
+
+    write_file(directory.file("records.data"), "3\n1:guid-1:a:10\n2:guid-2:b:20\n");
+    write_file(directory.file("records.data.journal"), "A:3:guid-3:c:30\nE:1:guid-1:d");
+
+    {
+        budget::data_handler<record> handler("records", "records.data");
+        handler.load();
+
+        auto& data = handler.unsafe_data();
+
+        REQUIRE(data.size() == 3);
+        FAST_CHECK_UNARY((data[0] == record{1, "guid-1", "a", 10}));
+        FAST_CHECK_UNARY((data[2] == record{3, "guid-3", "c", 30}));
+
+        // The truncated line is dropped from the journal
+        FAST_CHECK_EQ(read_file(directory.file("records.data.journal")), "A:3:guid-3:c:30\n");
+
+        // The next mutations are appended after the last complete line
+        handler.add(record{0, "guid-4", "e", 40});
+        handler.save();
+    }
+
+    auto data = load_records();
+
+    REQUIRE(data.size() == 4);
+    FAST_CHECK_UNARY((data[3] == record{4, "guid-4", "e", 40}));
+}
+
+TEST_CASE("data/journal/compaction") {
+    temporary_directory directory;
+
+    budget::config_set("journal_max_size", "100");
+
+    write_file(directory.file("records.data"), "2\n1:guid-1:a:10\n");
+
+    {
+        budget::data_handler<record> handler("records", "records.data");
+        handler.load();
+
+        handler.add(record{0, "guid-2", "b", 20});
+        handler.save();
+
+        // A small journal is kept next to the base file
+        FAST_CHECK_UNARY(fs::exists(directory.file("records.data.journal")));
+        FAST_CHECK_EQ(read_file(directory.file("records.data")), "2\n1:guid-1:a:10\n");
+
+        for (size_t i = 3; i < 10; ++i) {
+            handler.add(record{0, "guid-" + std::to_string(i), "name", int64_t(i)});
+        }
+
+        handler.save();
+    }
+
+    budget::config_remove("journal_max_size");
+
+    // Past journal_max_size, everything is written to the base file
+    FAST_CHECK_UNARY(!fs::exists(directory.file("records.data.journal")));
+
+    auto data = load_records();
+
+    REQUIRE(data.size() == 9);
+
+    for (size_t i = 0; i < data.size(); ++i) {
+        FAST_CHECK_EQ(data[i].id, i + 1);
+    }
+
+    FAST_CHECK_EQ(read_file(directory.file("records.data")).substr(0, 3), "10\n");
+}
+
+TEST_CASE("data/persistence/stop") {
+    temporary_directory directory;
+
+    write_file(directory.file("records.data"), "2\n1:guid-1:a:10\n");
+
+    budget::data_handler<record> handler("records", "records.data");
+    handler.load();
+
+    handler.add(record{0, "guid-2", "b", 20});
+    handler.set_changed();
+
+    {
+        // A long delay, only the stop can flush the changes in time
+        budget::config_set("persist_delay", "60000");
+        budget::config_set("persist_max_latency", "60000");
+
+        budget::persister persister([&handler]() { handler.save(); });
+
+        budget::config_remove("persist_delay");
+        budget::config_remove("persist_max_latency");
+
+        persister.notify();
+
+        budget::stop_persistence();
+
+        FAST_CHECK_UNARY(!handler.is_changed());
+    }
+
+    FAST_CHECK_EQ(read_file(directory.file("records.data")), "3\n1:guid-1:a:10\n2:guid-2:b:20\n");
+    FAST_CHECK_UNARY(!fs::exists(directory.file("records.data.journal")));
+}
+
+TEST_CASE("data/persistence/failed_write") {
+    temporary_directory directory;
+
+    std::string content = "2\n1:guid-1:a:10\n";
+
+    write_file(directory.file("records.data"), content);
+
+    budget::data_handler<record> handler("records", "records.data");
+    handler.load();
+
+    handler.add(record{0, "guid-2", "b", 20});
+    handler.set_changed();
+
+    // The temporary file cannot be created
+    fs::create_directory(directory.file("records.data.tmp"));
+
+    handler.save();
+
+    // The previous file is intact and the changes are still pending
+    FAST_CHECK_EQ(read_file(directory.file("records.data")), content);
+    FAST_CHECK_UNARY(handler.is_changed());
+
+    fs::remove(directory.file("records.data.tmp"));
+
+    handler.save();
+
+    FAST_CHECK_EQ(read_file(directory.file("records.data")), "3\n1:guid-1:a:10\n2:guid-2:b:20\n");
+    FAST_CHECK_UNARY(!handler.is_changed());
+}
+
+TEST_CASE("data/lookup") {
+    temporary_directory directory;
+
+    write_file(directory.file("records.data"), "3\n1:guid-1:a:10\n2:guid-2:b:20\n");
+
+    budget::data_handler<record> handler("records", "records.data");
+    handler.load();
+
+    auto entry = handler[2];
+
+    FAST_CHECK_EQ(entry->name, "b");
+
+    // The entry is read from a snapshot, it is not changed by an edit
+    handler.indirect_edit(record{2, "guid-2", "c", 30});
+
+    FAST_CHECK_EQ(entry->name, "b");
+    FAST_CHECK_EQ(handler[2]->name, "c");
+
+    REQUIRE_THROWS_AS(handler[3], budget::budget_exception);
+}
@@ -178,3 +178,29 @@ TEST_CASE("data_reader/double") {
 
     REQUIRE_THROWS_AS(reader >> d, budget::budget_exception);
 }
+
+TEST_CASE("data_reader/string") {
+    budget::data_reader reader;
+    reader.parse("a\\x3Ab:\\x3A::plain:x\\x3A\\x3Ay:");
+
+    std::string a, b, c, d, e;
+
+    reader >> a >> b >> c >> d >> e;
+
+    FAST_CHECK_EQ(a, "a:b"s);
+    FAST_CHECK_EQ(b, ":"s);
+    FAST_CHECK_EQ(c, ""s);
+    FAST_CHECK_EQ(d, "plain"s);
+    FAST_CHECK_EQ(e, "x::y"s);
+    FAST_CHECK_UNARY(!reader.more());
+
+    // The reader can be reused for the next line
+    reader.parse("1:second");
+
+    size_t id;
+    reader >> id >> a;
+
+    FAST_CHECK_EQ(id, 1);
+    FAST_CHECK_EQ(a, "second"s);
+    FAST_CHECK_UNARY(!reader.more());
+}
@@ -317,3 +317,16 @@ TEST_CASE("date/diff") {
     FAST_CHECK_EQ(budget::date(2231, 5, 5) - budget::date(2020, 3, 3), 77128);
     FAST_CHECK_EQ(budget::date(2020, 3, 3) - budget::date(2231, 5, 5), -77128);
 }
+
+TEST_CASE("date/day_number") {
+    FAST_CHECK_EQ(budget::date(2020, 3, 1).day_number() - budget::date(2020, 2, 28).day_number(), 2);
+    FAST_CHECK_EQ(budget::date(2021, 1, 1).day_number() - budget::date(2020, 1, 1).day_number(), 366);
+    FAST_CHECK_UNARY(budget::date(1666, 6, 6).day_number() < budget::date(2020, 1, 1).day_number());
+
+    budget::date d(1999, 12, 25);
+
+    for (size_t i = 0; i < 800; ++i) {
+        FAST_CHECK_EQ(budget::date::from_day_number(d.day_number()), d);
+        d += budget::days(1);
+    }
+}
@@ -0,0 +1,51 @@
+//=======================================================================
+// Copyright (c) 2013-2020 Baptiste Wicht
+// Distributed under the terms of the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+#include "test.hpp"
+#include "filter_iterator.hpp"
+
+namespace {
+
+struct value {
+    size_t id;
+    budget::money amount;
+};
+
+std::vector<value> values() {
+    return {{1, budget::money(10)}, {2, budget::money(20)}, {3, budget::money(30)}, {4, budget::money(40)}};
+}
+
+} // end of anonymous namespace
+
+TEST_CASE("filter_view/filter") {
+    auto v    = values();
+    auto view = budget::make_filter_view(v, [](const value& v) { return v.id % 2 == 0; });
+
+    std::vector<size_t> ids;
+
+    for (auto& value : view) {
+        ids.push_back(value.id);
+    }
+
+    REQUIRE(ids.size() == 2);
+    FAST_CHECK_EQ(ids[0], 2);
+    FAST_CHECK_EQ(ids[1], 4);
+
+    FAST_CHECK_EQ(view.to_vector().size(), 2);
+    FAST_CHECK_EQ(view.sum_amount(), budget::money(60));
+    FAST_CHECK_EQ(budget::accumulate_amount(view), budget::money(60));
+}
+
+TEST_CASE("filter_view/range") {
+    auto v = values();
+
+    budget::filter_view<value> view(v.begin() + 1, v.begin() + 3);
+
+    FAST_CHECK_EQ(view.to_vector().size(), 2);
+    FAST_CHECK_EQ(budget::accumulate_amount(view), budget::money(50));
+    FAST_CHECK_EQ(budget::accumulate_amount(budget::filter_view<value>(v.end(), v.end())), budget::money(0));
+}
@@ -0,0 +1,78 @@
+//=======================================================================
+// Copyright (c) 2013-2020 Baptiste Wicht
+// Distributed under the terms of the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+#include "test.hpp"
+#include "month_index.hpp"
+
+namespace {
+
+struct record {
+    size_t id;
+    size_t account;
+    budget::date date;
+};
+
+std::vector<record> records() {
+    return {
+        {1, 2, budget::date(2019, 5, 3)},
+        {2, 1, budget::date(2018, 12, 31)},
+        {3, 1, budget::date(2019, 5, 1)},
+        {4, 2, budget::date(2019, 1, 15)},
+        {5, 1, budget::date(2019, 5, 20)},
+        {6, 3, budget::date(2020, 2, 1)},
+    };
+}
+
+template <typename Range>
+std::vector<size_t> ids(const Range& range) {
+    std::vector<size_t> ids;
+
+    for (auto it = range.first; it != range.second; ++it) {
+        ids.push_back(it->id);
+    }
+
+    return ids;
+}
+
+} // end of anonymous namespace
+
+TEST_CASE("month_index/months") {
+    budget::month_index<record> index(records());
+
+    FAST_CHECK_EQ(index.sorted().size(), 6);
+    FAST_CHECK_EQ(index.sorted().front().id, 2);
+    FAST_CHECK_EQ(index.sorted().back().id, 6);
+
+    // Within a month, the records are in the order of the file
+    FAST_CHECK_UNARY((ids(index.month(2019, 5)) == std::vector<size_t>{1, 3, 5}));
+    FAST_CHECK_UNARY((ids(index.month(2018, 12)) == std::vector<size_t>{2}));
+    FAST_CHECK_UNARY(ids(index.month(2019, 2)).empty());
+    FAST_CHECK_UNARY(ids(index.month(2017, 5)).empty());
+    FAST_CHECK_UNARY(ids(index.month(2021, 5)).empty());
+
+    FAST_CHECK_UNARY((ids(index.year(2019)) == std::vector<size_t>{4, 1, 3, 5}));
+    FAST_CHECK_UNARY((ids(index.between(2019, 2, 5)) == std::vector<size_t>{1, 3, 5}));
+    FAST_CHECK_UNARY(ids(index.between(2019, 6, 5)).empty());
+}
+
+TEST_CASE("month_index/accounts") {
+    budget::month_index<record> index(records());
+
+    FAST_CHECK_UNARY((ids(index.month(1, 2019, 5)) == std::vector<size_t>{3, 5}));
+    FAST_CHECK_UNARY((ids(index.month(2, 2019, 5)) == std::vector<size_t>{1}));
+    FAST_CHECK_UNARY((ids(index.between(2, 2019, 1, 12)) == std::vector<size_t>{4, 1}));
+    FAST_CHECK_UNARY((ids(index.month(3, 2020, 2)) == std::vector<size_t>{6}));
+    FAST_CHECK_UNARY(ids(index.month(3, 2019, 2)).empty());
+    FAST_CHECK_UNARY(ids(index.month(4, 2019, 5)).empty());
+}
+
+TEST_CASE("month_index/empty") {
+    budget::month_index<record> index(std::vector<record>{});
+
+    FAST_CHECK_UNARY(ids(index.month(2019, 5)).empty());
+    FAST_CHECK_UNARY(ids(index.month(1, 2019, 5)).empty());
+}
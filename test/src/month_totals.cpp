@@ -0,0 +1,96 @@
+//=======================================================================
+// Copyright (c) 2013-2020 Baptiste Wicht
+// Distributed under the terms of the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+#include <algorithm>
+
+#include "test.hpp"
+#include "month_totals.hpp"
+#include "transactions.hpp"
+#include "expenses.hpp"
+#include "earnings.hpp"
+#include "accounts.hpp"
+
+namespace {
+
+template <typename T>
+T make(size_t account, budget::date date, budget::money amount) {
+    T value;
+    value.id      = 0;
+    value.account = account;
+    value.date    = date;
+    value.amount  = amount;
+    return value;
+}
+
+budget::account make_account(size_t id, const std::string& name) {
+    budget::account account;
+    account.id   = id;
+    account.name = name;
+    return account;
+}
+
+budget::month_totals make_totals() {
+    std::vector<budget::expense> expenses{
+        make<budget::expense>(1, budget::date(2019, 5, 3), budget::money(10)),
+        make<budget::expense>(1, budget::date(2019, 5, 20), budget::money(5)),
+        make<budget::expense>(2, budget::date(2019, 3, 1), budget::money(7)),
+        make<budget::expense>(3, budget::date(2020, 1, 1), budget::money(100)),
+        make<budget::expense>(1, budget::TEMPLATE_DATE, budget::money(1000)),
+    };
+
+    std::vector<budget::earning> earnings{
+        make<budget::earning>(2, budget::date(2019, 5, 10), budget::money(20)),
+        make<budget::earning>(3, budget::date(2019, 4, 10), budget::money(30)),
+    };
+
+    // The accounts 1 and 3 are two versions of the same account
+    std::vector<budget::account> accounts{make_account(1, "Food"), make_account(2, "Car"), make_account(3, "Food")};
+
+    auto by_date = [](auto& lhs, auto& rhs) { return lhs.date < rhs.date; };
+
+    std::sort(expenses.begin(), expenses.end(), by_date);
+    std::sort(earnings.begin(), earnings.end(), by_date);
+
+    return budget::month_totals(budget::transactions(expenses), budget::transactions(earnings), accounts);
+}
+
+} // end of anonymous namespace
+
+TEST_CASE("month_totals/all") {
+    auto totals = make_totals();
+
+    FAST_CHECK_EQ(totals.expenses(2019, 5), budget::money(15));
+    FAST_CHECK_EQ(totals.expenses(2019, 4), budget::money(0));
+    FAST_CHECK_EQ(totals.expenses(2018, 5), budget::money(0));
+    FAST_CHECK_EQ(totals.expenses_between(2019, 1, 12), budget::money(22));
+    FAST_CHECK_EQ(totals.expenses_between(2020, 1, 12), budget::money(100));
+    FAST_CHECK_EQ(totals.earnings(2019, 5), budget::money(20));
+    FAST_CHECK_EQ(totals.earnings_between(2019, 4, 5), budget::money(50));
+}
+
+TEST_CASE("month_totals/accounts") {
+    auto totals = make_totals();
+
+    FAST_CHECK_EQ(totals.account_expenses(1, 2019, 5), budget::money(15));
+    FAST_CHECK_EQ(totals.account_expenses(2, 2019, 5), budget::money(0));
+    FAST_CHECK_EQ(totals.account_expenses(4, 2019, 5), budget::money(0));
+    FAST_CHECK_EQ(totals.account_expenses_between(2, 2019, 1, 6), budget::money(7));
+    FAST_CHECK_EQ(totals.account_earnings(2, 2019, 5), budget::money(20));
+    FAST_CHECK_EQ(totals.account_earnings_between(3, 2019, 1, 12), budget::money(30));
+
+    FAST_CHECK_EQ(totals.account_expenses("Food", 2020, 1), budget::money(100));
+    FAST_CHECK_EQ(totals.account_earnings("Food", 2019, 4), budget::money(30));
+    FAST_CHECK_EQ(totals.account_expenses("Bike", 2019, 5), budget::money(0));
+}
+
+TEST_CASE("month_totals/start_month") {
+    auto totals = make_totals();
+
+    FAST_CHECK_EQ(totals.start_month(2019).value, 3);
+    FAST_CHECK_EQ(totals.start_month(2020).value, 1);
+    FAST_CHECK_EQ(totals.start_month(2021).value, 12);
+}
@@ -0,0 +1,122 @@
+//=======================================================================
+// Copyright (c) 2013-2020 Baptiste Wicht
+// Distributed under the terms of the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+#include "test.hpp"
+#include "net_worth.hpp"
+
+namespace {
+
+budget::asset make_asset(size_t id, bool share_based) {
+    budget::asset asset;
+    asset.id          = id;
+    asset.name        = "asset" + std::to_string(id);
+    asset.currency    = "CHF";
+    asset.share_based = share_based;
+    asset.ticker      = share_based ? "VT" : "";
+    return asset;
+}
+
+budget::asset_value make_value(size_t asset_id, budget::date date, long amount, bool liability = false) {
+    budget::asset_value value;
+    value.asset_id  = asset_id;
+    value.set_date  = date;
+    value.amount    = budget::money(amount);
+    value.liability = liability;
+    return value;
+}
+
+budget::asset_share make_share(size_t asset_id, budget::date date, int64_t shares) {
+    budget::asset_share share;
+    share.asset_id = asset_id;
+    share.date     = date;
+    share.shares   = shares;
+    return share;
+}
+
+} // end of anonymous namespace
+
+TEST_CASE("net_worth_series/asset_value") {
+    std::vector<budget::asset> assets{make_asset(1, false), make_asset(2, false)};
+
+    std::vector<budget::asset_value> values{
+        make_value(1, budget::date(2019, 1, 1), 100),
+        make_value(2, budget::date(2019, 1, 15), 50),
+        make_value(1, budget::date(2019, 2, 1), 200),
+        make_value(1, budget::date(2019, 2, 1), 300),
+    };
+
+    budget::net_worth_series series(assets, {}, values, budget::share_positions({}));
+
+    FAST_CHECK_EQ(series.asset_value(assets[0], budget::date(2018, 12, 31)), budget::money(0));
+    FAST_CHECK_EQ(series.asset_value(assets[0], budget::date(2019, 1, 1)), budget::money(100));
+    FAST_CHECK_EQ(series.asset_value(assets[0], budget::date(2019, 1, 31)), budget::money(100));
+    FAST_CHECK_EQ(series.asset_value(assets[0], budget::date(2019, 2, 1)), budget::money(300));
+    FAST_CHECK_EQ(series.asset_value(assets[0], budget::date(2025, 1, 1)), budget::money(300));
+
+    FAST_CHECK_EQ(series.asset_value(assets[1], budget::date(2019, 1, 14)), budget::money(0));
+    FAST_CHECK_EQ(series.asset_value(assets[1], budget::date(2019, 3, 1)), budget::money(50));
+}
+
+TEST_CASE("net_worth_series/liability_value") {
+    std::vector<budget::asset> assets{make_asset(1, false)};
+
+    budget::liability liability;
+    liability.id       = 1;
+    liability.currency = "CHF";
+
+    std::vector<budget::asset_value> values{
+        make_value(1, budget::date(2019, 1, 1), 100),
+        make_value(1, budget::date(2019, 1, 10), 1000, true),
+        make_value(1, budget::date(2019, 2, 10), 900, true),
+    };
+
+    budget::net_worth_series series(assets, {liability}, values, budget::share_positions({}));
+
+    FAST_CHECK_EQ(series.liability_value(liability, budget::date(2019, 1, 5)), budget::money(0));
+    FAST_CHECK_EQ(series.liability_value(liability, budget::date(2019, 1, 10)), budget::money(1000));
+    FAST_CHECK_EQ(series.liability_value(liability, budget::date(2019, 3, 1)), budget::money(900));
+    FAST_CHECK_EQ(series.asset_value(assets[0], budget::date(2019, 3, 1)), budget::money(100));
+}
+
+TEST_CASE("net_worth_series/asset_shares") {
+    std::vector<budget::asset> assets{make_asset(1, true)};
+
+    std::vector<budget::asset_share> shares{
+        make_share(1, budget::date(2019, 3, 1), 10),
+        make_share(1, budget::date(2019, 1, 1), 5),
+        make_share(1, budget::date(2019, 3, 1), -2),
+        make_share(2, budget::date(2019, 3, 1), 100),
+    };
+
+    budget::net_worth_series series(assets, {}, {}, budget::share_positions(shares));
+
+    FAST_CHECK_EQ(series.asset_shares(assets[0], budget::date(2018, 1, 1)), 0);
+    FAST_CHECK_EQ(series.asset_shares(assets[0], budget::date(2019, 2, 1)), 5);
+    FAST_CHECK_EQ(series.asset_shares(assets[0], budget::date(2019, 3, 1)), 13);
+    FAST_CHECK_EQ(series.asset_shares(assets[0], budget::date(2030, 3, 1)), 13);
+}
+
+TEST_CASE("net_worth_series/distant_dates") {
+    std::vector<budget::asset> assets{make_asset(1, false), make_asset(2, false)};
+
+    // A mistyped date far from the others
+    std::vector<budget::asset_value> values{
+        make_value(1, budget::date(1900, 1, 1), 10),
+        make_value(2, budget::date(2019, 1, 1), 50),
+        make_value(1, budget::date(2100, 1, 1), 100),
+    };
+
+    budget::net_worth_series series(assets, {}, values, budget::share_positions({}));
+
+    FAST_CHECK_EQ(series.asset_value(assets[0], budget::date(1899, 12, 31)), budget::money(0));
+    FAST_CHECK_EQ(series.asset_value(assets[0], budget::date(2019, 1, 1)), budget::money(10));
+    FAST_CHECK_EQ(series.asset_value(assets[1], budget::date(2019, 1, 1)), budget::money(50));
+    FAST_CHECK_EQ(series.asset_value(assets[1], budget::date(2018, 12, 31)), budget::money(0));
+    FAST_CHECK_EQ(series.asset_value(assets[0], budget::date(2099, 12, 31)), budget::money(10));
+    FAST_CHECK_EQ(series.asset_value(assets[0], budget::date(2100, 1, 1)), budget::money(100));
+    FAST_CHECK_EQ(series.asset_value(assets[1], budget::date(2200, 1, 1)), budget::money(50));
+}
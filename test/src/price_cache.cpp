@@ -0,0 +1,119 @@
+//=======================================================================
+// Copyright (c) 2013-2020 Baptiste Wicht
+// Distributed under the terms of the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+#include <cstdio>
+#include <fstream>
+
+#include "test.hpp"
+#include "price_cache.hpp"
+
+TEST_CASE("price_cache/append") {
+    const std::string path = "price_cache_test.cache";
+
+    std::remove(path.c_str());
+
+    {
+        budget::price_cache_file file(path);
+
+        std::vector<budget::price_record> records;
+        FAST_CHECK_UNARY(!file.load(records));
+
+        auto vt  = file.key_id("VT");
+        auto bnd = file.key_id("A_VERY_LONG_TICKER_NAME");
+
+        REQUIRE(file.append({{vt, 100, 9000}, {bnd, 100, 8000}}));
+        REQUIRE(budget::is_price_cache_file(path));
+
+        REQUIRE(file.append({{vt, 101, 9100}}));
+    }
+
+    // A new key is defined in the middle of the file
+    {
+        budget::price_cache_file file(path);
+
+        std::vector<budget::price_record> records;
+        REQUIRE(file.load(records));
+        REQUIRE(file.append({{file.key_id("CHF:EUR"), 101, 42}}));
+    }
+
+    budget::price_cache_file file(path);
+
+    std::vector<budget::price_record> records;
+    REQUIRE(file.load(records));
+    REQUIRE(records.size() == 4);
+
+    FAST_CHECK_EQ(file.key(records[0].key), "VT");
+    FAST_CHECK_EQ(records[0].day, 100);
+    FAST_CHECK_EQ(records[0].value, 9000);
+    FAST_CHECK_EQ(file.key(records[1].key), "A_VERY_LONG_TICKER_NAME");
+    FAST_CHECK_EQ(records[1].value, 8000);
+    FAST_CHECK_EQ(file.key(records[2].key), "VT");
+    FAST_CHECK_EQ(records[2].day, 101);
+    FAST_CHECK_EQ(file.key(records[3].key), "CHF:EUR");
+    FAST_CHECK_EQ(records[3].value, 42);
+
+    std::remove(path.c_str());
+}
+
+TEST_CASE("price_cache/truncated") {
+    const std::string path = "price_cache_test.cache";
+
+    {
+        budget::price_cache_file file(path);
+
+        std::vector<budget::price_record> records;
+        file.load(records);
+        REQUIRE(file.append({{file.key_id("VT"), 100, 9000}}));
+    }
+
+    // Simulate an interrupted append
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::app);
+        out.write("garbage", 7);
+    }
+
+    {
+        budget::price_cache_file file(path);
+
+        std::vector<budget::price_record> records;
+        REQUIRE(file.load(records));
+        FAST_CHECK_EQ(records.size(), 1);
+        REQUIRE(file.append({{file.key_id("VT"), 101, 9100}}));
+    }
+
+    budget::price_cache_file file(path);
+
+    std::vector<budget::price_record> records;
+    REQUIRE(file.load(records));
+    REQUIRE(records.size() == 2);
+    FAST_CHECK_EQ(records[1].day, 101);
+    FAST_CHECK_EQ(records[1].value, 9100);
+
+    std::remove(path.c_str());
+}
+
+TEST_CASE("price_cache/text") {
+    const std::string path = "price_cache_test.cache";
+
+    {
+        std::ofstream out(path);
+        out << "2020-01-01:CHF:EUR:1.1" << std::endl;
+    }
+
+    FAST_CHECK_UNARY(!budget::is_price_cache_file(path));
+
+    budget::price_cache_file file(path);
+
+    std::vector<budget::price_record> records;
+    FAST_CHECK_UNARY(!file.load(records));
+
+    // The file is replaced by the first append
+    REQUIRE(file.append({{file.key_id("VT"), 100, 9000}}));
+    FAST_CHECK_UNARY(budget::is_price_cache_file(path));
+
+    std::remove(path.c_str());
+}
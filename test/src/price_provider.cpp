@@ -0,0 +1,110 @@
+//=======================================================================
+// Copyright (c) 2013-2020 Baptiste Wicht
+// Distributed under the terms of the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <memory>
+
+#include "test.hpp"
+#include "price_provider.hpp"
+#include "price_cache.hpp"
+#include "currency.hpp"
+#include "share.hpp"
+
+TEST_CASE("price_provider/csv") {
+    const std::string path = "price_provider_test.csv";
+
+    {
+        std::ofstream file(path);
+        file << "2020-01-02,VT,80.50" << std::endl;
+        file << "2020-01-03,VT,81.25" << std::endl;
+        file << "2020-01-06,VT,79.00" << std::endl;
+        file << "2020-01-02,EUR,CHF,1.08" << std::endl;
+        file << "2020-01-06,EUR,CHF,1.25" << std::endl;
+    }
+
+    budget::file_price_provider provider(path);
+
+    FAST_CHECK_EQ(provider.size(), 5);
+
+    auto quotes = provider.quotes("VT", budget::date(2020, 1, 3), budget::date(2020, 1, 10));
+    REQUIRE(quotes.size() == 2);
+    FAST_CHECK_EQ(quotes[budget::date(2020, 1, 3)], budget::money(81, 25));
+    FAST_CHECK_EQ(quotes[budget::date(2020, 1, 6)], budget::money(79));
+    FAST_CHECK_UNARY(provider.quotes("BND", budget::date(2020, 1, 1), budget::date(2020, 1, 10)).empty());
+
+    // The days without rate have the previous rate
+    double value = 0;
+    REQUIRE(provider.rate("EUR", "CHF", budget::date(2020, 1, 4), value));
+    FAST_CHECK_EQ(value, 1.08);
+    REQUIRE(provider.rate("CHF", "EUR", budget::date(2020, 1, 6), value));
+    FAST_CHECK_EQ(value, 1.0 / 1.25);
+    FAST_CHECK_UNARY(!provider.rate("EUR", "CHF", budget::date(2020, 1, 1), value));
+    FAST_CHECK_UNARY(!provider.rate("EUR", "USD", budget::date(2020, 1, 4), value));
+
+    auto rates = provider.rates("CHF", "EUR", budget::date(2020, 1, 1), budget::date(2020, 1, 5));
+    REQUIRE(rates.size() == 1);
+    FAST_CHECK_EQ(rates[budget::date(2020, 1, 2)], 1.0 / 1.08);
+
+    std::remove(path.c_str());
+}
+
+TEST_CASE("price_provider/binary") {
+    const std::string path = "price_provider_test.cache";
+
+    std::remove(path.c_str());
+
+    {
+        budget::price_cache_file file(path);
+
+        double rate = 0.5;
+        int64_t bits;
+        std::memcpy(&bits, &rate, sizeof(bits));
+
+        REQUIRE(file.append({{file.key_id("VT"), budget::date(2020, 1, 2).day_number(), 8050},
+                             {file.key_id("USD:CHF"), budget::date(2020, 1, 2).day_number(), bits}}));
+    }
+
+    budget::file_price_provider provider(path);
+
+    FAST_CHECK_EQ(provider.quotes("VT", budget::date(2020, 1, 1), budget::date(2020, 1, 2))[budget::date(2020, 1, 2)], budget::money(80, 50));
+
+    double value = 0;
+    REQUIRE(provider.rate("USD", "CHF", budget::date(2020, 1, 3), value));
+    FAST_CHECK_EQ(value, 0.5);
+
+    std::remove(path.c_str());
+}
+
+TEST_CASE("price_provider/offline") {
+    const std::string path = "price_provider_offline.csv";
+
+    {
+        std::ofstream file(path);
+        file << "2020-01-02,OFFLINE_TICKER,12.50" << std::endl;
+        file << "2020-01-03,OFFLINE_TICKER,13.00" << std::endl;
+        file << "2020-01-02,GBP,SEK,12.5" << std::endl;
+    }
+
+    auto provider = std::make_shared<budget::file_price_provider>(path);
+
+    budget::set_share_price_provider(provider);
+    budget::set_exchange_rate_provider(provider);
+
+    // 2020-01-04 is a saturday, the price of the friday is used
+    FAST_CHECK_EQ(budget::share_price("OFFLINE_TICKER", budget::date(2020, 1, 4)), budget::money(13));
+    FAST_CHECK_EQ(budget::share_price("OFFLINE_TICKER", budget::date(2020, 1, 2)), budget::money(12, 50));
+
+    FAST_CHECK_EQ(budget::exchange_rate("GBP", "SEK", budget::date(2020, 1, 4)), 12.5);
+    FAST_CHECK_EQ(budget::exchange_rate("SEK", "GBP", budget::date(2020, 1, 2)), 1.0 / 12.5);
+
+    budget::set_share_price_provider(nullptr);
+    budget::set_exchange_rate_provider(nullptr);
+
+    std::remove(path.c_str());
+}
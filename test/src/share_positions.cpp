@@ -0,0 +1,77 @@
+//=======================================================================
+// Copyright (c) 2013-2020 Baptiste Wicht
+// Distributed under the terms of the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+#include "test.hpp"
+#include "share_positions.hpp"
+
+namespace {
+
+budget::asset_share make_share(size_t asset_id, budget::date date, int64_t shares, long price) {
+    budget::asset_share share;
+    share.asset_id = asset_id;
+    share.date     = date;
+    share.shares   = shares;
+    share.price    = budget::money(price);
+    return share;
+}
+
+budget::share_positions make_positions() {
+    std::vector<budget::asset_share> shares{
+        make_share(1, budget::date(2019, 3, 1), 10, 20),
+        make_share(1, budget::date(2019, 1, 1), 10, 10),
+        make_share(2, budget::date(2019, 2, 1), 5, 100),
+        make_share(1, budget::date(2019, 5, 1), -5, 30),
+        make_share(1, budget::date(2019, 5, 1), -5, 30),
+    };
+
+    return budget::share_positions(shares);
+}
+
+} // end of anonymous namespace
+
+TEST_CASE("share_positions/shares") {
+    auto positions = make_positions();
+
+    FAST_CHECK_EQ(positions.positions(1).size(), 3);
+    FAST_CHECK_EQ(positions.positions(3).size(), 0);
+
+    FAST_CHECK_EQ(positions.shares(1, budget::date(2018, 12, 31)), 0);
+    FAST_CHECK_EQ(positions.shares(1, budget::date(2019, 1, 1)), 10);
+    FAST_CHECK_EQ(positions.shares(1, budget::date(2019, 4, 1)), 20);
+    FAST_CHECK_EQ(positions.shares(1, budget::date(2019, 5, 1)), 10);
+    FAST_CHECK_EQ(positions.shares(2, budget::date(2019, 5, 1)), 5);
+    FAST_CHECK_EQ(positions.shares(3, budget::date(2019, 5, 1)), 0);
+}
+
+TEST_CASE("share_positions/cost_basis") {
+    auto positions = make_positions();
+
+    FAST_CHECK_EQ(positions.cost_basis(1, budget::date(2019, 2, 1)), budget::money(100));
+    FAST_CHECK_EQ(positions.cost_basis(1, budget::date(2019, 4, 1)), budget::money(300));
+
+    // The 10 sold shares had an average cost of 15
+    FAST_CHECK_EQ(positions.cost_basis(1, budget::date(2019, 6, 1)), budget::money(150));
+    FAST_CHECK_EQ(positions.realized_gain(1, budget::date(2019, 4, 1)), budget::money(0));
+    FAST_CHECK_EQ(positions.realized_gain(1, budget::date(2019, 6, 1)), budget::money(150));
+}
+
+TEST_CASE("share_positions/unrealized_gain") {
+    auto positions = make_positions();
+
+    FAST_CHECK_EQ(positions.unrealized_gain(1, budget::date(2018, 12, 31), budget::money(50)), budget::money(0));
+    FAST_CHECK_EQ(positions.unrealized_gain(1, budget::date(2019, 2, 1), budget::money(12)), budget::money(20));
+
+    // 20 shares with a cost basis of 300
+    FAST_CHECK_EQ(positions.unrealized_gain(1, budget::date(2019, 4, 1), budget::money(10)), budget::money(-100));
+
+    // The realized gains are not part of the unrealized gains
+    FAST_CHECK_EQ(positions.unrealized_gain(1, budget::date(2019, 6, 1), budget::money(30)), budget::money(150));
+    FAST_CHECK_EQ(positions.realized_gain(1, budget::date(2019, 6, 1)), budget::money(150));
+
+    // Without shares, no price is needed
+    FAST_CHECK_EQ(positions.unrealized_gain(3, budget::date(2019, 6, 1)), budget::money(0));
+}
@@ -0,0 +1,38 @@
+//=======================================================================
+// Copyright (c) 2013-2020 Baptiste Wicht
+// Distributed under the terms of the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+#include "test.hpp"
+#include "string_table.hpp"
+
+TEST_CASE("string_table/intern") {
+    budget::string_table table;
+
+    auto food = table.intern("Food");
+    auto fuel = table.intern("Fuel");
+
+    FAST_CHECK_EQ(table.intern("Food"), food);
+    FAST_CHECK_NE(food, fuel);
+    FAST_CHECK_EQ(table.str(food), "Food");
+    FAST_CHECK_EQ(table.str(fuel), "Fuel");
+
+    // The lower case versions are interned as well
+    FAST_CHECK_EQ(table.size(), 4);
+}
+
+TEST_CASE("string_table/folded") {
+    budget::string_table table;
+
+    auto upper = table.intern("FOOD");
+    auto mixed = table.intern("Food");
+    auto lower = table.intern("food");
+    auto other = table.intern("fuel");
+
+    FAST_CHECK_EQ(table.folded(upper), lower);
+    FAST_CHECK_EQ(table.folded(mixed), lower);
+    FAST_CHECK_EQ(table.folded(lower), lower);
+    FAST_CHECK_EQ(table.folded(other), other);
+}
@@ -0,0 +1,63 @@
+//=======================================================================
+// Copyright (c) 2013-2020 Baptiste Wicht
+// Distributed under the terms of the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+#include "test.hpp"
+#include "transactions.hpp"
+
+namespace {
+
+struct record {
+    budget::date date;
+    std::string name;
+    size_t account;
+    budget::money amount;
+};
+
+budget::transactions make_transactions() {
+    std::vector<record> records{
+        {budget::date(1666, 6, 6), "template", 1, budget::money(1000)},
+        {budget::date(2019, 1, 31), "food", 1, budget::money(10)},
+        {budget::date(2019, 2, 1), "fuel", 2, budget::money(20)},
+        {budget::date(2019, 2, 15), "food", 1, budget::money(30)},
+        {budget::date(2019, 3, 1), "food", 2, budget::money(40)},
+    };
+
+    return budget::transactions(records);
+}
+
+} // end of anonymous namespace
+
+TEST_CASE("transactions/columns") {
+    auto t = make_transactions();
+
+    REQUIRE(t.size() == 5);
+    FAST_CHECK_EQ(t.names[1], t.names[3]);
+    FAST_CHECK_NE(t.names[1], t.names[2]);
+    FAST_CHECK_EQ(budget::names().str(t.names[2]), "fuel");
+    FAST_CHECK_EQ(t.accounts[2], 2);
+    FAST_CHECK_EQ(t.amounts[4], budget::money(40).value);
+}
+
+TEST_CASE("transactions/sum") {
+    auto t = make_transactions();
+
+    auto february = t.between(budget::date(2019, 2, 1), budget::date(2019, 2, 28));
+
+    FAST_CHECK_EQ(february.first, 2);
+    FAST_CHECK_EQ(february.second, 4);
+    FAST_CHECK_EQ(t.sum(february), budget::money(50));
+    FAST_CHECK_EQ(t.sum(february, 1), budget::money(30));
+    FAST_CHECK_EQ(t.sum(t.between(budget::date(2019, 1, 1), budget::date(2019, 12, 31))), budget::money(100));
+    FAST_CHECK_EQ(t.sum(t.between(budget::date(2020, 1, 1), budget::date(2020, 12, 31))), budget::money(0));
+}
+
+TEST_CASE("transactions/first_date") {
+    auto t = make_transactions();
+
+    FAST_CHECK_EQ(t.first_date(budget::date(1666, 6, 6), budget::date(2020, 1, 1)), budget::date(2019, 1, 31));
+    FAST_CHECK_EQ(budget::transactions().first_date(budget::date(1666, 6, 6), budget::date(2020, 1, 1)), budget::date(2020, 1, 1));
+}
@@ -0,0 +1,64 @@
+//=======================================================================
+// Copyright (c) 2013-2020 Baptiste Wicht
+// Distributed under the terms of the MIT License.
+// (See accompanying file LICENSE or copy at
+//  http://opensource.org/licenses/MIT)
+//=======================================================================
+
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "test.hpp"
+#include "worker_pool.hpp"
+
+TEST_CASE("worker_pool/all") {
+    std::vector<size_t> values(100, 0);
+
+    budget::parallel_for(values.size(), 8, [&values](size_t i) { values[i] = i * 2; });
+
+    for (size_t i = 0; i < values.size(); ++i) {
+        FAST_CHECK_EQ(values[i], i * 2);
+    }
+}
+
+TEST_CASE("worker_pool/bounded") {
+    std::atomic<size_t> running{0};
+    std::atomic<size_t> max_running{0};
+
+    budget::parallel_for(32, 3, [&](size_t) {
+        auto current = ++running;
+
+        size_t previous = max_running;
+        while (current > previous && !max_running.compare_exchange_weak(previous, current)) {}
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+        --running;
+    });
+
+    FAST_CHECK_UNARY(max_running <= 3);
+}
+
+TEST_CASE("worker_pool/error") {
+    std::atomic<size_t> calls{0};
+
+    bool thrown = false;
+
+    try {
+        budget::parallel_for(10, 4, [&calls](size_t i) {
+            ++calls;
+
+            if (i == 5) {
+                throw std::runtime_error("error");
+            }
+        });
+    } catch (const std::runtime_error&) {
+        thrown = true;
+    }
+
+    FAST_CHECK_UNARY(thrown);
+    FAST_CHECK_EQ(calls, 10);
+}